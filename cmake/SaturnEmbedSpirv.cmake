@@ -0,0 +1,39 @@
+# Writes the SPIR-V module INPUT to the header OUTPUT as a constexpr array
+# of words named NAME in namespace NAMESPACE. Run with cmake -P.
+
+file(READ "${INPUT}" hex HEX)
+string(LENGTH "${hex}" length)
+math(EXPR remainder "${length} % 8")
+
+if(length EQUAL 0 OR NOT remainder EQUAL 0)
+	message(FATAL_ERROR "${INPUT} is not a whole number of SPIR-V words")
+endif()
+
+# SPIR-V is written in the byte order of the host that compiled it, which
+# is little endian for every target Vulkan runs on
+string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1, " words "${hex}")
+string(REPEAT "0x[0-9a-f]+, " 6 line)
+string(REGEX REPLACE "(${line})" "\\1\n\t    " words "${words}")
+string(REPLACE " \n" "\n" words "${words}")
+string(REGEX REPLACE ",[ \n\t]*$" "" words "${words}")
+
+string(TOUPPER "${NAMESPACE}_${NAME}" guard)
+get_filename_component(file "${INPUT}" NAME)
+
+file(WRITE "${OUTPUT}"
+"// Generated from ${file} by saturn_embed_shaders, do not edit
+
+#ifndef ${guard}_HPP
+#define ${guard}_HPP
+
+#include <cstdint>
+
+namespace ${NAMESPACE}
+{
+	alignas(4) inline constexpr uint32_t ${NAME}[] = {
+	    ${words}
+	};
+} // namespace ${NAMESPACE}
+
+#endif
+")
@@ -0,0 +1,70 @@
+# saturn_embed_shaders(<target> [NAMESPACE <namespace>] SOURCES <glsl>...)
+#
+# Compiles each GLSL source to SPIR-V with glslangValidator, or glslc when
+# it isn't found, and embeds the result in a header that <target> can
+# include as "<file name>.hpp". The header declares the module as an
+# aligned constexpr array of words, named after the file with every
+# character other than letters and digits replaced by an underscore, in
+# <namespace> (shaders by default). Pass the array to
+# sat::ShaderLoader::fromBytes to create the module without any file I/O.
+
+# Cached so projects that add saturn as a subdirectory can call the function
+set(SATURN_EMBED_SPIRV_SCRIPT "${CMAKE_CURRENT_LIST_DIR}/SaturnEmbedSpirv.cmake"
+	CACHE INTERNAL "Script that embeds SPIR-V in a header")
+
+function(saturn_embed_shaders target)
+	cmake_parse_arguments(ARG "" "NAMESPACE" "SOURCES" ${ARGN})
+
+	if(NOT ARG_NAMESPACE)
+		set(ARG_NAMESPACE shaders)
+	endif()
+
+	find_program(SATURN_GLSLANG_VALIDATOR glslangValidator
+		HINTS "$ENV{VULKAN_SDK}/bin"
+	)
+	find_program(SATURN_GLSLC glslc HINTS "$ENV{VULKAN_SDK}/bin")
+
+	set(directory "${CMAKE_CURRENT_BINARY_DIR}/${target}_shaders")
+	set(headers)
+
+	foreach(source IN LISTS ARG_SOURCES)
+		get_filename_component(source "${source}" ABSOLUTE)
+		get_filename_component(file "${source}" NAME)
+		string(MAKE_C_IDENTIFIER "${file}" name)
+
+		set(spirv "${directory}/${file}.spv")
+		set(header "${directory}/${file}.hpp")
+
+		if(SATURN_GLSLANG_VALIDATOR)
+			set(compile "${SATURN_GLSLANG_VALIDATOR}" -V -o "${spirv}" "${source}")
+		elseif(SATURN_GLSLC)
+			set(compile "${SATURN_GLSLC}" -o "${spirv}" "${source}")
+		else()
+			message(FATAL_ERROR "Neither glslangValidator nor glslc was found")
+		endif()
+
+		add_custom_command(
+			OUTPUT "${spirv}"
+			COMMAND "${CMAKE_COMMAND}" -E make_directory "${directory}"
+			COMMAND ${compile}
+			DEPENDS "${source}"
+			COMMENT "Compiling ${file} to SPIR-V"
+			VERBATIM
+		)
+
+		add_custom_command(
+			OUTPUT "${header}"
+			COMMAND "${CMAKE_COMMAND}" "-DINPUT=${spirv}" "-DOUTPUT=${header}"
+				"-DNAME=${name}" "-DNAMESPACE=${ARG_NAMESPACE}"
+				-P "${SATURN_EMBED_SPIRV_SCRIPT}"
+			DEPENDS "${spirv}" "${SATURN_EMBED_SPIRV_SCRIPT}"
+			COMMENT "Embedding ${file}.spv"
+			VERBATIM
+		)
+
+		list(APPEND headers "${header}")
+	endforeach()
+
+	target_sources(${target} PRIVATE ${headers})
+	target_include_directories(${target} PRIVATE "${directory}")
+endfunction()
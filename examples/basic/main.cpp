@@ -7,6 +7,9 @@
 #include "saturn/pipeline.hpp"
 #include "saturn/sync.hpp"
 
+#include "basic.frag.hpp"
+#include "basic.vert.hpp"
+
 namespace crit = sat::criterion;
 namespace dev  = sat::device;
 
@@ -85,7 +88,9 @@ int main()
 
 	auto deviceBuilder = sat::DeviceBuilder(instance, physicalDevice)
 	                         .addExtension(VK_KHR_SWAPCHAIN_EXTENSION_NAME)
-	                         .addQueue(graphicsQueueFamily);
+	                         .addQueue(graphicsQueueFamily)
+	                         .deferDestruction()
+	                         .pipelineCache("basic.cache");
 
 	if (graphicsQueueFamily != presentQueueFamily)
 	{
@@ -124,56 +129,35 @@ int main()
 	//// Render Pass ////
 	/////////////////////
 
-	sat::rn<sat::RenderPass> renderPass =
+	// Framebuffers come from the device's cache when recording, and are
+	// dropped along with the swap chain views they were created from
+	sat::RenderPassCache renderPasses;
+
+	sat::rn<sat::RenderPass> renderPass = renderPasses.get(
 	    sat::RenderPassBuilder(device)
 	        .createColorAttachment(swapchain->format())
 	        .begin()
 	        .addColorAttachment(0)
-	        .end()
-	        .build();
-
-	//////////////////////
-	//// Framebuffers ////
-	//////////////////////
-
-	std::vector<sat::rn<sat::Framebuffer>> framebuffers;
-	framebuffers.reserve(swapchain->views().size());
-
-	for (VkImageView view : swapchain->views())
-	{
-		sat::rn<sat::Framebuffer> framebuffer =
-		    sat::FramebufferBuilder(device, renderPass)
-		        .extent(swapchain->extent())
-		        .add(view)
-		        .build();
-
-		framebuffers.push_back(framebuffer);
-	}
+	        .end());
 
 	/////////////////
 	//// Shaders ////
 	/////////////////
 
 	sat::ShaderLoader loader(device);
-	sat::rn<sat::Shader> vert = loader.fromFile("basic.vert.spv");
-	sat::rn<sat::Shader> frag = loader.fromFile("basic.frag.spv");
+	sat::rn<sat::Shader> vert = loader.fromBytes(shaders::basic_vert);
+	sat::rn<sat::Shader> frag = loader.fromBytes(shaders::basic_frag);
 
 	//////////////////
 	//// Pipeline ////
 	//////////////////
 
 	sat::rn<sat::Pipeline> pipeline =
-	    sat::PipelineBuilder(device, swapchain, renderPass)
+	    sat::PipelineBuilder(device, renderPass)
 	        .addStage(VK_SHADER_STAGE_VERTEX_BIT, vert)
 	        .addStage(VK_SHADER_STAGE_FRAGMENT_BIT, frag)
-	        .addDynamicState(VK_DYNAMIC_STATE_VIEWPORT)
-	        .addDynamicState(VK_DYNAMIC_STATE_SCISSOR)
-	        .vertexDescription(
-	            sat::VertexDescription()
-	                .begin(sizeof(float) * 5)
-	                .add(VK_FORMAT_R32G32_SFLOAT, 0)
-	                .add(VK_FORMAT_R32G32B32_SFLOAT, sizeof(float) * 2)
-	                .end())
+	        .reflect()
+	        .name("basic")
 	        .build();
 
 	/////////////////
@@ -257,7 +241,11 @@ int main()
 
 		cmd.reset();
 		cmd.record();
-		cmd.begin(renderPass, framebuffers[imageIndex], swapchain->extent());
+
+		VkFramebuffer framebuffer = device->framebufferCache().get(
+		    renderPass, swapchain->views()[imageIndex], swapchain->extent());
+
+		cmd.begin(renderPass, framebuffer, swapchain->extent());
 
 		cmd.bindPipeline(pipeline);
 		cmd.bindVertexBuffer(vertex);
@@ -275,15 +263,26 @@ int main()
 
 		VkPipelineStageFlags waitStages[]{VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT};
 
+		// Signal the device timeline so deferred objects can be freed
+		VkSemaphore signalSemaphores[]{renderFinishedSemaphore,
+		                               device->timeline()};
+		uint64_t signalValues[]{0, device->frame()};
+
+		VkTimelineSemaphoreSubmitInfo timelineInfo{};
+		timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineInfo.signalSemaphoreValueCount = 2;
+		timelineInfo.pSignalSemaphoreValues    = signalValues;
+
 		VkSubmitInfo submitInfo{};
 		submitInfo.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.pNext                = &timelineInfo;
 		submitInfo.waitSemaphoreCount   = 1;
 		submitInfo.pWaitSemaphores      = imageAvailableSemaphore;
 		submitInfo.pWaitDstStageMask    = waitStages;
 		submitInfo.commandBufferCount   = 1;
 		submitInfo.pCommandBuffers      = cmd;
-		submitInfo.signalSemaphoreCount = 1;
-		submitInfo.pSignalSemaphores    = renderFinishedSemaphore;
+		submitInfo.signalSemaphoreCount = 2;
+		submitInfo.pSignalSemaphores    = signalSemaphores;
 
 		SATURN_CALL(vkQueueSubmit(graphics, 1, &submitInfo, inFlightFence));
 
@@ -300,6 +299,8 @@ int main()
 		presentInfo.pImageIndices      = &imageIndex;
 
 		vkQueuePresentKHR(present, &presentInfo);
+
+		device->advance();
 	}
 
 	/////////////////
@@ -307,6 +308,7 @@ int main()
 	/////////////////
 
 	device->waitIdle();
+	device->pipelineStats().dump(std::cout);
 
 	inFlightFence.reset();
 	renderFinishedSemaphore.reset();
@@ -323,12 +325,8 @@ int main()
 	frag.reset();
 	vert.reset();
 
-	for (sat::rn<sat::Framebuffer>& framebuffer : framebuffers)
-	{
-		framebuffer.reset();
-	}
-
 	renderPass.reset();
+	renderPasses.clear();
 	swapchain.reset();
 	device.reset();
 	vkDestroySurfaceKHR(instance, surface, nullptr);
@@ -0,0 +1,136 @@
+#ifndef SATURN_BINDLESS_HPP
+#define SATURN_BINDLESS_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "core.hpp"
+#include "pipeline.hpp"
+
+namespace sat
+{
+	class BindlessTable;
+	class Device;
+
+	////////////////////////////////
+	//// Bindless Table Builder ////
+	////////////////////////////////
+
+	class SATURN_API BindlessTableBuilder
+	    : public Builder<BindlessTableBuilder, BindlessTable>
+	{
+	public:
+		explicit BindlessTableBuilder(rn<Device> device) noexcept;
+
+		/**
+		 * \brief Adds an array of \p count descriptors of \p type at the
+		 * next binding.
+		 */
+		BindlessTableBuilder& addArray(
+		    VkDescriptorType type,
+		    uint32_t count,
+		    VkShaderStageFlags stages = VK_SHADER_STAGE_ALL) noexcept;
+
+	private:
+		friend class BindlessTable;
+
+		rn<Device> device_;
+		DescriptorLayout layout_;
+	};
+
+	////////////////////////
+	//// Bindless Table ////
+	////////////////////////
+
+	/**
+	 * \brief A single descriptor set of large, partially bound arrays that
+	 * shaders index into, so draws don't need to bind descriptor sets of
+	 * their own. Every resource added gets a stable slot in its array.
+	 *
+	 * Pipelines use the table by adding \ref layout() as one of their
+	 * descriptor layouts.
+	 */
+	class SATURN_API BindlessTable : public Container<VkDescriptorSet>
+	{
+	public:
+		~BindlessTable() noexcept;
+
+		BindlessTable(const BindlessTable&)            = delete;
+		BindlessTable& operator=(const BindlessTable&) = delete;
+
+		/**
+		 * \brief Writes a buffer into a free slot of \p binding.
+		 *
+		 * \return Index of the slot in the array.
+		 */
+		uint32_t add(uint32_t binding,
+		             VkBuffer buffer,
+		             VkDeviceSize offset = 0,
+		             VkDeviceSize range  = VK_WHOLE_SIZE);
+
+		/**
+		 * \brief Writes an image into a free slot of \p binding.
+		 *
+		 * \return Index of the slot in the array.
+		 */
+		uint32_t add(uint32_t binding,
+		             VkImageView view,
+		             VkImageLayout layout,
+		             VkSampler sampler = VK_NULL_HANDLE);
+
+		/**
+		 * \brief Frees \p slot of \p binding. The slot is handed out again
+		 * once the current frame has completed on the device.
+		 *
+		 * Throws when \p slot isn't in use, so a slot freed twice is never
+		 * handed to two resources.
+		 */
+		void remove(uint32_t binding, uint32_t slot);
+
+		const DescriptorLayout& layout() const noexcept { return layout_; }
+
+		VkDescriptorSetLayout descriptorLayout() const noexcept
+		{
+			return descriptorLayout_;
+		}
+
+	private:
+		friend class Builder<BindlessTableBuilder, BindlessTable>;
+
+		struct Retired
+		{
+			uint64_t frame;
+			uint32_t slot;
+		};
+
+		struct Array
+		{
+			VkDescriptorType type;
+			uint32_t count;
+			uint32_t next = 0;
+			std::vector<bool> live;
+			std::vector<uint32_t> free;
+			std::deque<Retired> retired;
+		};
+
+		explicit BindlessTable(const BindlessTableBuilder& builder);
+
+		uint32_t acquire(uint32_t binding);
+		void write(uint32_t binding,
+		           uint32_t slot,
+		           const VkDescriptorBufferInfo* pBufferInfo,
+		           const VkDescriptorImageInfo* pImageInfo);
+
+		rn<Device> device_;
+		DescriptorLayout layout_;
+		VkDescriptorSetLayout descriptorLayout_;
+		VkDescriptorPool pool_ = VK_NULL_HANDLE;
+		std::vector<Array> arrays_;
+		std::mutex mutex_;
+	};
+} // namespace sat
+
+#endif
@@ -5,7 +5,9 @@
 
 #include <mutex>
 #include <semaphore>
+#include <span>
 #include <stack>
+#include <type_traits>
 
 #include "core.hpp"
 
@@ -15,6 +17,27 @@ namespace sat
 	class CommandDispatcher;
 	class CommandPool;
 	class Device;
+	class Pipeline;
+	class ShaderObject;
+	class VertexDescription;
+	struct DeviceDispatch;
+
+	//////////////////////////////
+	//// Rendering Attachment ////
+	//////////////////////////////
+
+	/**
+	 * \brief Attachment of a pass begun with
+	 * \ref CommandBuffer::beginRendering.
+	 */
+	struct RenderingAttachment
+	{
+		VkImageView view;
+		VkImageLayout layout        = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		VkAttachmentLoadOp loadOp   = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		VkAttachmentStoreOp storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		VkClearValue clearValue     = {{0, 0, 0, 1}};
+	};
 
 	//////////////////////////////
 	//// Command Pool Builder ////
@@ -85,6 +108,20 @@ namespace sat
 		           const VkOffset2D& offset = {0, 0}) noexcept;
 		void end() noexcept;
 
+		/**
+		 * \brief Begins dynamic rendering into the given attachments, which
+		 * must already be in their layouts. Needs VK_KHR_dynamic_rendering.
+		 */
+		void beginRendering(
+		    const VkExtent2D& extent,
+		    std::span<RenderingAttachment const> colorAttachments,
+		    const RenderingAttachment* pDepthAttachment   = nullptr,
+		    const RenderingAttachment* pStencilAttachment = nullptr,
+		    const VkOffset2D& offset                      = {0, 0});
+		void beginRendering(const VkExtent2D& extent,
+		                    const RenderingAttachment& colorAttachment);
+		void endRendering() noexcept;
+
 		void viewport(const VkExtent2D& extent,
 		              const VkOffset2D& offset = {0, 0},
 		              float min                = 0,
@@ -95,7 +132,118 @@ namespace sat
 		             const VkOffset2D& offset = {0, 0}) noexcept;
 		void scissor(const VkRect2D& scissor) noexcept;
 
-		void bindPipeline(VkPipeline pipeline) noexcept;
+		// Extended dynamic state. Each setter requires its extension and
+		// feature to be enabled, and the bound pipeline to declare the state
+		// dynamic.
+		void cullMode(VkCullModeFlags cullMode) noexcept;
+		void frontFace(VkFrontFace frontFace) noexcept;
+		void topology(VkPrimitiveTopology topology) noexcept;
+		void viewports(std::span<VkViewport const> viewports) noexcept;
+		void scissors(std::span<VkRect2D const> scissors) noexcept;
+		void depthTest(bool enable) noexcept;
+		void depthWrite(bool enable) noexcept;
+		void depthCompareOp(VkCompareOp compareOp) noexcept;
+		void depthBoundsTest(bool enable) noexcept;
+		void stencilTest(bool enable) noexcept;
+		void stencilOp(VkStencilFaceFlags faces,
+		               VkStencilOp failOp,
+		               VkStencilOp passOp,
+		               VkStencilOp depthFailOp,
+		               VkCompareOp compareOp) noexcept;
+
+		void rasterizerDiscard(bool enable) noexcept;
+		void depthBias(bool enable) noexcept;
+		void primitiveRestart(bool enable) noexcept;
+
+		void polygonMode(VkPolygonMode polygonMode) noexcept;
+		void rasterizationSamples(VkSampleCountFlagBits samples) noexcept;
+		void alphaToCoverage(bool enable) noexcept;
+		void depthClamp(bool enable) noexcept;
+		void logicOp(bool enable) noexcept;
+		void colorBlend(uint32_t first,
+		                std::span<VkBool32 const> enables) noexcept;
+		void colorBlendEquation(
+		    uint32_t first,
+		    std::span<VkColorBlendEquationEXT const> equations) noexcept;
+		void colorWriteMask(
+		    uint32_t first,
+		    std::span<VkColorComponentFlags const> masks) noexcept;
+		void sampleMask(VkSampleCountFlagBits samples,
+		                VkSampleMask mask = ~0u) noexcept;
+
+		/**
+		 * \brief Sets the vertex input, which shader objects always take
+		 * from the command buffer.
+		 */
+		void vertexInput(const VertexDescription& description);
+
+		void bindPipeline(VkPipeline pipeline,
+		                  VkPipelineBindPoint bindPoint =
+		                      VK_PIPELINE_BIND_POINT_GRAPHICS) noexcept;
+
+		/**
+		 * \brief Binds \p pipeline to the bind point it was built for, and
+		 * remembers its layout for \ref push.
+		 */
+		void bindPipeline(const rn<Pipeline>& pipeline) noexcept;
+
+		/**
+		 * \brief Binds \p shader to \p stage, or unbinds the stage when
+		 * null.
+		 */
+		void bindShader(VkShaderStageFlagBits stage,
+		                VkShaderEXT shader) noexcept;
+
+		/**
+		 * \brief Binds every stage of \p shaders, and remembers their
+		 * layout for \ref push.
+		 */
+		void bindShaders(const rn<ShaderObject>& shaders) noexcept;
+
+		void pushConstants(VkPipelineLayout layout,
+		                   VkShaderStageFlags stages,
+		                   uint32_t offset,
+		                   uint32_t size,
+		                   const void* pValues) noexcept;
+
+		/**
+		 * \brief Updates the push constants of the last pipeline or shader
+		 * objects bound through \ref bindPipeline(const rn<Pipeline>&) or
+		 * \ref bindShaders. Binding a raw pipeline forgets that layout, so
+		 * pass it explicitly after one.
+		 */
+		template <typename T>
+		    requires std::is_trivially_copyable_v<T>
+		void push(VkShaderStageFlags stages,
+		          const T& value,
+		          uint32_t offset = 0) noexcept
+		{
+			static_assert(sizeof(T) % 4 == 0,
+			              "Push constant size must be a multiple of 4");
+			pushConstants(layout_, stages, offset, sizeof(T), &value);
+		}
+
+		template <typename T>
+		    requires std::is_trivially_copyable_v<T>
+		void push(VkPipelineLayout layout,
+		          VkShaderStageFlags stages,
+		          const T& value,
+		          uint32_t offset = 0) noexcept
+		{
+			static_assert(sizeof(T) % 4 == 0,
+			              "Push constant size must be a multiple of 4");
+			pushConstants(layout, stages, offset, sizeof(T), &value);
+		}
+
+		/**
+		 * \brief Binds \p sets starting at set \p first. Sets stay bound
+		 * across pipelines whose layouts match up to that set.
+		 */
+		void bindDescriptorSets(VkPipelineLayout layout,
+		                        std::span<VkDescriptorSet const> sets,
+		                        uint32_t first = 0,
+		                        VkPipelineBindPoint bindPoint =
+		                            VK_PIPELINE_BIND_POINT_GRAPHICS) noexcept;
 
 		void bindVertexBuffer(VkBuffer buffer,
 		                      VkDeviceSize offset = 0) noexcept;
@@ -108,6 +256,42 @@ namespace sat
 
 		void drawIndexed(uint32_t count, uint32_t index = 0) noexcept;
 
+		void dispatch(uint32_t x, uint32_t y = 1, uint32_t z = 1) noexcept;
+
+		/**
+		 * \brief Dispatches with the group counts read from \p buffer as a
+		 * \ref VkDispatchIndirectCommand.
+		 */
+		void dispatchIndirect(VkBuffer buffer,
+		                      VkDeviceSize offset = 0) noexcept;
+
+		/**
+		 * \brief Makes writes to \p buffer by \p srcStage visible to reads
+		 * by \p dstStage, such as a compute pass feeding vertex input.
+		 */
+		void barrier(VkBuffer buffer,
+		             VkPipelineStageFlags srcStage,
+		             VkAccessFlags srcAccess,
+		             VkPipelineStageFlags dstStage,
+		             VkAccessFlags dstAccess,
+		             VkDeviceSize offset = 0,
+		             VkDeviceSize size   = VK_WHOLE_SIZE) noexcept;
+
+		/**
+		 * \brief Moves \p image from \p oldLayout to \p newLayout once
+		 * \p srcStage is done with it, such as a swap chain image around
+		 * dynamic rendering.
+		 */
+		void transition(
+		    VkImage image,
+		    VkImageLayout oldLayout,
+		    VkImageLayout newLayout,
+		    VkPipelineStageFlags srcStage,
+		    VkAccessFlags srcAccess,
+		    VkPipelineStageFlags dstStage,
+		    VkAccessFlags dstAccess,
+		    VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT) noexcept;
+
 		void copy(VkBuffer dst,
 		          VkBuffer src,
 		          VkDeviceSize size,
@@ -120,7 +304,10 @@ namespace sat
 	private:
 		friend class CommandPool;
 
-		explicit CommandBuffer(VkCommandBuffer handle);
+		CommandBuffer(VkCommandBuffer handle, const DeviceDispatch* pDispatch);
+
+		const DeviceDispatch* dispatch_ = nullptr;
+		VkPipelineLayout layout_        = VK_NULL_HANDLE;
 	};
 
 	////////////////////////////////////
@@ -60,6 +60,8 @@ namespace sat
 
 		const T* get() const noexcept { return item_.get(); }
 
+		long useCount() const noexcept { return item_.use_count(); }
+
 	private:
 		std::shared_ptr<T> item_;
 	};
@@ -0,0 +1,293 @@
+#ifndef SATURN_DESCRIPTOR_HPP
+#define SATURN_DESCRIPTOR_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <deque>
+#include <list>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core.hpp"
+
+namespace sat
+{
+	class Device;
+	class DescriptorAllocator;
+
+	//////////////////////////////////////
+	//// Descriptor Allocator Builder ////
+	//////////////////////////////////////
+
+	class SATURN_API DescriptorAllocatorBuilder
+	    : public Builder<DescriptorAllocatorBuilder, DescriptorAllocator>
+	{
+	public:
+		explicit DescriptorAllocatorBuilder(rn<Device> device) noexcept;
+
+		/**
+		 * \brief Sets the number of sets in the first pool. Every pool added
+		 * to the chain holds twice as many as the one before, up to 64 times
+		 * the first.
+		 */
+		DescriptorAllocatorBuilder& maxSets(uint32_t count) noexcept;
+
+		/**
+		 * \brief Reserves \p perSet descriptors of \p type for every set in a
+		 * pool. Defaults to a mix of common types when none are given.
+		 */
+		DescriptorAllocatorBuilder& addPoolSize(VkDescriptorType type,
+		                                        float perSet) noexcept;
+
+		DescriptorAllocatorBuilder& flags(
+		    VkDescriptorPoolCreateFlags flags) noexcept;
+
+		/**
+		 * \brief Keeps a separate chain of pools for each of \p count frames
+		 * in flight. Sets are only valid during the frame that allocated
+		 * them, and a chain is reset once its previous frame has completed
+		 * on the device timeline.
+		 */
+		DescriptorAllocatorBuilder& perFrame(unsigned count) noexcept;
+
+	private:
+		friend class DescriptorAllocator;
+
+		rn<Device> device_;
+		uint32_t maxSets_ = 64;
+		std::vector<std::pair<VkDescriptorType, float>> sizes_;
+		VkDescriptorPoolCreateFlags flags_ = 0;
+		unsigned frames_                   = 0;
+	};
+
+	//////////////////////////////
+	//// Descriptor Allocator ////
+	//////////////////////////////
+
+	/**
+	 * \brief Allocates descriptor sets from a chain of pools that grows
+	 * whenever the current pool runs out.
+	 */
+	class SATURN_API DescriptorAllocator
+	{
+	public:
+		~DescriptorAllocator() noexcept;
+
+		DescriptorAllocator(const DescriptorAllocator&)            = delete;
+		DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+		VkDescriptorSet allocate(VkDescriptorSetLayout layout);
+
+		/**
+		 * \brief Allocates one set per layout with a single call. Throws when
+		 * even a new pool can't fit them.
+		 */
+		std::vector<VkDescriptorSet> allocate(
+		    std::span<VkDescriptorSetLayout const> layouts);
+
+		/**
+		 * \brief Returns every set to its pool. Sets must no longer be in use.
+		 */
+		void reset();
+
+	private:
+		friend class Builder<DescriptorAllocatorBuilder, DescriptorAllocator>;
+
+		struct Chain
+		{
+			std::vector<VkDescriptorPool> pools;
+			size_t current = 0;
+			uint64_t frame = 0;
+		};
+
+		explicit DescriptorAllocator(const DescriptorAllocatorBuilder& builder);
+
+		Chain& chain();
+		void reset(Chain& chain);
+		VkDescriptorPool createPool(uint32_t maxSets) const;
+
+		rn<Device> device_;
+		uint32_t maxSets_;
+		std::vector<std::pair<VkDescriptorType, float>> sizes_;
+		VkDescriptorPoolCreateFlags flags_;
+		bool perFrame_;
+		std::vector<Chain> chains_;
+		std::mutex mutex_;
+	};
+
+	///////////////////////////
+	//// Descriptor Writer ////
+	///////////////////////////
+
+	/**
+	 * \brief Collects descriptor writes and applies them with a single
+	 * \ref vkUpdateDescriptorSets call.
+	 */
+	class SATURN_API DescriptorWriter
+	{
+	public:
+		DescriptorWriter() noexcept = default;
+
+		DescriptorWriter& buffer(VkDescriptorSet set,
+		                         uint32_t binding,
+		                         VkDescriptorType type,
+		                         VkBuffer buffer,
+		                         VkDeviceSize offset = 0,
+		                         VkDeviceSize range  = VK_WHOLE_SIZE,
+		                         uint32_t element    = 0);
+
+		DescriptorWriter& image(VkDescriptorSet set,
+		                        uint32_t binding,
+		                        VkDescriptorType type,
+		                        VkImageView view,
+		                        VkImageLayout layout,
+		                        VkSampler sampler = VK_NULL_HANDLE,
+		                        uint32_t element  = 0);
+
+		/**
+		 * \brief Applies every collected write and clears the writer.
+		 */
+		void update(VkDevice device);
+
+	private:
+		std::vector<VkWriteDescriptorSet> writes_;
+
+		// Deques keep the infos that writes point to in place
+		std::deque<VkDescriptorBufferInfo> buffers_;
+		std::deque<VkDescriptorImageInfo> images_;
+	};
+
+	/////////////////////////////
+	//// Descriptor Bindings ////
+	/////////////////////////////
+
+	/**
+	 * \brief Resources bound to the bindings of a descriptor set, without
+	 * the set itself.
+	 */
+	class SATURN_API DescriptorBindings
+	{
+	public:
+		DescriptorBindings() noexcept = default;
+
+		DescriptorBindings& buffer(uint32_t binding,
+		                           VkDescriptorType type,
+		                           VkBuffer buffer,
+		                           VkDeviceSize offset = 0,
+		                           VkDeviceSize range  = VK_WHOLE_SIZE,
+		                           uint32_t element    = 0);
+
+		DescriptorBindings& image(uint32_t binding,
+		                          VkDescriptorType type,
+		                          VkImageView view,
+		                          VkImageLayout layout,
+		                          VkSampler sampler = VK_NULL_HANDLE,
+		                          uint32_t element  = 0);
+
+		/**
+		 * \brief Queues writes of every binding into \p set.
+		 */
+		void write(DescriptorWriter& writer, VkDescriptorSet set) const;
+
+	private:
+		friend class DescriptorSetCache;
+
+		struct Entry
+		{
+			uint32_t binding;
+			uint32_t element;
+			VkDescriptorType type;
+			VkDescriptorBufferInfo buffer;
+			VkDescriptorImageInfo image;
+			bool isImage;
+		};
+
+		std::vector<Entry> entries_;
+	};
+
+	//////////////////////////////
+	//// Descriptor Set Cache ////
+	//////////////////////////////
+
+	/**
+	 * \brief Shares descriptor sets between requests for the same layout and
+	 * bindings, so repeated bindings cost no writes. Sets unused for a number
+	 * of frames are evicted and recycled for later requests. Sets using a view
+	 * or buffer owned by saturn are evicted as soon as it dies.
+	 *
+	 * Ages are measured on the device's frame timeline.
+	 */
+	class SATURN_API DescriptorSetCache
+	{
+	public:
+		/**
+		 * \brief Evicts sets that haven't been requested for \p maxAge
+		 * frames.
+		 */
+		explicit DescriptorSetCache(rn<Device> device, uint64_t maxAge = 8);
+		~DescriptorSetCache() noexcept;
+
+		DescriptorSetCache(const DescriptorSetCache&)            = delete;
+		DescriptorSetCache& operator=(const DescriptorSetCache&) = delete;
+
+		/**
+		 * \brief Returns a set of \p layout holding \p bindings, writing
+		 * one only when no such set is cached.
+		 */
+		VkDescriptorSet get(VkDescriptorSetLayout layout,
+		                    const DescriptorBindings& bindings);
+
+		/**
+		 * \brief Evicts every set that is too old and no longer in use by the
+		 * device. Meant to be called once per frame.
+		 */
+		void collect();
+
+		/**
+		 * \brief Evicts every set using \p view, recycling it once the
+		 * frames using it have completed.
+		 */
+		void invalidateView(VkImageView view);
+
+		/**
+		 * \brief Evicts every set using \p buffer, recycling it once the
+		 * frames using it have completed.
+		 */
+		void invalidateBuffer(VkBuffer buffer);
+
+		size_t size() const;
+
+	private:
+		struct Entry
+		{
+			std::string key;
+			VkDescriptorSetLayout layout;
+			VkDescriptorSet set;
+			uint64_t frame;
+			std::vector<VkImageView> views;
+			std::vector<VkBuffer> buffers;
+		};
+
+		template <typename F>
+		void drop(F&& predicate);
+
+		rn<Device> device_;
+		uint64_t maxAge_;
+		rn<DescriptorAllocator> allocator_;
+
+		// Least recently used first
+		std::list<Entry> entries_;
+		std::unordered_map<std::string, std::list<Entry>::iterator> sets_;
+
+		// Evicted sets that frames in flight may still use
+		std::vector<Entry> retired_;
+		std::unordered_map<VkDescriptorSetLayout, std::vector<VkDescriptorSet>>
+		    free_;
+		mutable std::mutex mutex_;
+	};
+} // namespace sat
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef SATURN_DESCRIPTOR_TEMPLATE_HPP
+#define SATURN_DESCRIPTOR_TEMPLATE_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <stdexcept>
+#include <type_traits>
+
+#include "core.hpp"
+#include "pipeline.hpp"
+
+namespace sat
+{
+	class DescriptorTemplate;
+	class Device;
+
+	/////////////////////////////////////
+	//// Descriptor Template Builder ////
+	/////////////////////////////////////
+
+	class SATURN_API DescriptorTemplateBuilder
+	    : public Builder<DescriptorTemplateBuilder, DescriptorTemplate>
+	{
+	public:
+		DescriptorTemplateBuilder(rn<Device> device,
+		                          const DescriptorLayout& layout) noexcept;
+
+	private:
+		friend class DescriptorTemplate;
+
+		rn<Device> device_;
+		DescriptorLayout layout_;
+	};
+
+	/////////////////////////////
+	//// Descriptor Template ////
+	/////////////////////////////
+
+	/**
+	 * \brief Writes every binding of a descriptor set from one packed struct,
+	 * which is the cheapest way to update a set on the CPU.
+	 *
+	 * The struct holds one array per binding, in the order the bindings were
+	 * added to the layout, with as many elements as the binding's count. The
+	 * elements are \ref VkDescriptorBufferInfo for buffers,
+	 * \ref VkBufferView for texel buffers and \ref VkDescriptorImageInfo for
+	 * samplers and images. Layouts with any other type, such as inline
+	 * uniform blocks, are rejected.
+	 */
+	class SATURN_API DescriptorTemplate
+	    : public Container<VkDescriptorUpdateTemplate>
+	{
+	public:
+		~DescriptorTemplate() noexcept;
+
+		DescriptorTemplate(const DescriptorTemplate&)            = delete;
+		DescriptorTemplate& operator=(const DescriptorTemplate&) = delete;
+
+		template <typename T>
+		    requires std::is_trivially_copyable_v<T> && (!std::is_pointer_v<T>)
+		void update(VkDescriptorSet set, const T& data) const;
+
+		/**
+		 * \brief Writes \p set from packed data of at least \ref size()
+		 * bytes.
+		 */
+		void update(VkDescriptorSet set, const void* pData) const noexcept;
+
+		/**
+		 * \brief Size in bytes of the packed struct.
+		 */
+		size_t size() const noexcept { return size_; }
+
+		VkDescriptorSetLayout descriptorLayout() const noexcept
+		{
+			return descriptorLayout_;
+		}
+
+	private:
+		friend class Builder<DescriptorTemplateBuilder, DescriptorTemplate>;
+
+		explicit DescriptorTemplate(const DescriptorTemplateBuilder& builder);
+
+		rn<Device> device_;
+		VkDescriptorSetLayout descriptorLayout_;
+		size_t size_ = 0;
+	};
+
+	template <typename T>
+	    requires std::is_trivially_copyable_v<T> && (!std::is_pointer_v<T>)
+	inline void DescriptorTemplate::update(VkDescriptorSet set,
+	                                       const T& data) const
+	{
+		if (sizeof(T) < size_)
+		{
+			throw std::invalid_argument(
+			    "Data is smaller than the descriptor template");
+		}
+
+		update(set, static_cast<const void*>(&data));
+	}
+} // namespace sat
+
+#endif
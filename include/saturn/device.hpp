@@ -3,17 +3,31 @@
 
 #include <vulkan/vulkan.h>
 
+#include <atomic>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
 #include "allocator.hpp"
 #include "core.hpp"
+#include "dispatch.hpp"
 #include "physical_device.hpp"
 
 namespace sat
 {
+	class DescriptorSetCache;
 	class Device;
 	class Fence;
+	class FramebufferCache;
+	class LayoutCache;
+	class PipelineCache;
+	class PipelineStats;
 
 	////////////////////////
 	//// Device Builder ////
@@ -32,6 +46,28 @@ namespace sat
 
 		DeviceBuilder& addExtension(const char* pExtensionName) noexcept;
 
+		/**
+		 * \brief Enables the features of an extension by chaining a copy of
+		 * \p features, such as
+		 * \ref VkPhysicalDeviceExtendedDynamicStateFeaturesEXT, into the
+		 * device's create info.
+		 */
+		template <typename T>
+		DeviceBuilder& addFeatures(const T& features);
+
+		/**
+		 * \brief Hands buffers, pipelines and framebuffers to the device's
+		 * deletion queue when released instead of destroying them
+		 * immediately.
+		 */
+		DeviceBuilder& deferDestruction() noexcept;
+
+		/**
+		 * \brief Loads the device's pipeline cache from \p path and saves it
+		 * back when the device is destroyed.
+		 */
+		DeviceBuilder& pipelineCache(std::filesystem::path path) noexcept;
+
 	private:
 		friend class Device;
 
@@ -39,8 +75,19 @@ namespace sat
 		PhysicalDevice device_;
 		std::unordered_map<uint32_t, std::vector<float>> queues_;
 		std::vector<const char*> extensions_;
+		std::vector<std::shared_ptr<VkBaseOutStructure>> features_;
+		bool defer_ = false;
+		std::filesystem::path cachePath_;
 	};
 
+	template <typename T>
+	inline DeviceBuilder& DeviceBuilder::addFeatures(const T& features)
+	{
+		features_.push_back(std::reinterpret_pointer_cast<VkBaseOutStructure>(
+		    std::make_shared<T>(features)));
+		return *this;
+	}
+
 	////////////////
 	//// Device ////
 	////////////////
@@ -61,15 +108,137 @@ namespace sat
 
 		VmaAllocator allocator() const noexcept { return allocator_; }
 
+		bool hasExtension(std::string_view extensionName) const noexcept;
+
+		/**
+		 * \brief Extension features of \p type enabled with
+		 * \ref DeviceBuilder::addFeatures, or null when they weren't added.
+		 */
+		template <typename T>
+		const T* features(VkStructureType type) const noexcept;
+
+		const DeviceDispatch& dispatch() const noexcept { return dispatch_; }
+
+		/**
+		 * \brief Timeline semaphore that the last submission of every frame
+		 * is expected to signal with the value of \ref frame().
+		 */
+		VkSemaphore timeline() const noexcept { return timeline_; }
+
+		/**
+		 * \brief Timeline value of the frame currently being recorded.
+		 */
+		uint64_t frame() const noexcept { return frame_; }
+
+		/**
+		 * \brief Timeline value of the last frame completed on the GPU.
+		 */
+		uint64_t completed() const;
+
+		/**
+		 * \brief Blocks until \p frame has completed on the GPU.
+		 */
+		void wait(uint64_t frame) const;
+
+		/**
+		 * \brief Moves on to the next frame and frees every deferred object
+		 * whose frame has completed.
+		 */
+		void advance();
+
+		/**
+		 * \brief Frees every deferred object whose frame has completed.
+		 */
+		void collect();
+
+		/**
+		 * \brief Runs \p deleter once the current frame has completed on the
+		 * GPU, or immediately when destruction isn't deferred.
+		 */
+		void destroy(std::function<void()> deleter);
+
+		bool deferred() const noexcept { return deferred_; }
+
+		PipelineCache& pipelineCache() const noexcept
+		{
+			return *pipelineCache_;
+		}
+
+		LayoutCache& layoutCache() const noexcept { return *layoutCache_; }
+
+		FramebufferCache& framebufferCache() const noexcept
+		{
+			return *framebufferCache_;
+		}
+
+		/**
+		 * \brief Drops every framebuffer and cached descriptor set using
+		 * \p view. Called when a view owned by saturn dies.
+		 */
+		void invalidateView(VkImageView view);
+
+		/**
+		 * \brief Drops every cached descriptor set using \p buffer. Called
+		 * when a buffer owned by saturn dies.
+		 */
+		void invalidateBuffer(VkBuffer buffer);
+
+		/**
+		 * \brief Creation time of every pipeline built on this device.
+		 */
+		PipelineStats& pipelineStats() const noexcept
+		{
+			return *pipelineStats_;
+		}
+
 	private:
 		friend class Builder<DeviceBuilder, Device>;
+		friend class DescriptorSetCache;
+
+		struct Deletion
+		{
+			uint64_t frame;
+			std::function<void()> deleter;
+		};
 
 		explicit Device(const DeviceBuilder& builder);
 
 		rn<Instance> instance_;
 		PhysicalDevice device_;
 		VmaAllocator allocator_;
+		std::vector<std::string> extensions_;
+		std::vector<std::shared_ptr<VkBaseOutStructure>> features_;
+		DeviceDispatch dispatch_;
+
+		bool deferred_;
+		VkSemaphore timeline_ = VK_NULL_HANDLE;
+		std::atomic<uint64_t> frame_ = 1;
+		std::deque<Deletion> deletions_;
+		std::mutex mutex_;
+
+		std::unique_ptr<PipelineCache> pipelineCache_;
+		std::unique_ptr<LayoutCache> layoutCache_;
+		std::unique_ptr<FramebufferCache> framebufferCache_;
+		std::unique_ptr<PipelineStats> pipelineStats_;
+
+		// Descriptor set caches register themselves to be invalidated
+		std::vector<DescriptorSetCache*> setCaches_;
+		std::mutex setCacheMutex_;
 	};
+
+	template <typename T>
+	inline const T* Device::features(VkStructureType type) const noexcept
+	{
+		for (const auto& pFeatures : features_)
+		{
+			if (pFeatures->sType == type)
+			{
+				return reinterpret_cast<const T*>(pFeatures.get());
+			}
+		}
+
+		return nullptr;
+	}
 } // namespace sat
 
 #endif
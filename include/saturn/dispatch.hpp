@@ -0,0 +1,71 @@
+#ifndef SATURN_DISPATCH_HPP
+#define SATURN_DISPATCH_HPP
+
+#include <vulkan/vulkan.h>
+
+#include "core.hpp"
+
+namespace sat
+{
+	/////////////////////////
+	//// Device Dispatch ////
+	/////////////////////////
+
+	/**
+	 * \brief Device-level entry points of extensions, which the loader
+	 * doesn't export. Entries of extensions that weren't enabled are null.
+	 */
+	struct SATURN_API DeviceDispatch
+	{
+		void load(VkDevice device) noexcept;
+
+		// VK_EXT_extended_dynamic_state
+		PFN_vkCmdSetCullModeEXT vkCmdSetCullModeEXT                   = nullptr;
+		PFN_vkCmdSetFrontFaceEXT vkCmdSetFrontFaceEXT                 = nullptr;
+		PFN_vkCmdSetPrimitiveTopologyEXT vkCmdSetPrimitiveTopologyEXT = nullptr;
+		PFN_vkCmdSetViewportWithCountEXT vkCmdSetViewportWithCountEXT = nullptr;
+		PFN_vkCmdSetScissorWithCountEXT vkCmdSetScissorWithCountEXT   = nullptr;
+		PFN_vkCmdSetDepthTestEnableEXT vkCmdSetDepthTestEnableEXT     = nullptr;
+		PFN_vkCmdSetDepthWriteEnableEXT vkCmdSetDepthWriteEnableEXT   = nullptr;
+		PFN_vkCmdSetDepthCompareOpEXT vkCmdSetDepthCompareOpEXT       = nullptr;
+		PFN_vkCmdSetDepthBoundsTestEnableEXT
+		    vkCmdSetDepthBoundsTestEnableEXT = nullptr;
+		PFN_vkCmdSetStencilTestEnableEXT vkCmdSetStencilTestEnableEXT = nullptr;
+		PFN_vkCmdSetStencilOpEXT vkCmdSetStencilOpEXT                 = nullptr;
+
+		// VK_EXT_extended_dynamic_state2
+		PFN_vkCmdSetRasterizerDiscardEnableEXT
+		    vkCmdSetRasterizerDiscardEnableEXT = nullptr;
+		PFN_vkCmdSetDepthBiasEnableEXT vkCmdSetDepthBiasEnableEXT = nullptr;
+		PFN_vkCmdSetPrimitiveRestartEnableEXT
+		    vkCmdSetPrimitiveRestartEnableEXT = nullptr;
+
+		// VK_EXT_extended_dynamic_state3
+		PFN_vkCmdSetPolygonModeEXT vkCmdSetPolygonModeEXT = nullptr;
+		PFN_vkCmdSetRasterizationSamplesEXT vkCmdSetRasterizationSamplesEXT =
+		    nullptr;
+		PFN_vkCmdSetAlphaToCoverageEnableEXT
+		    vkCmdSetAlphaToCoverageEnableEXT = nullptr;
+		PFN_vkCmdSetDepthClampEnableEXT vkCmdSetDepthClampEnableEXT = nullptr;
+		PFN_vkCmdSetLogicOpEnableEXT vkCmdSetLogicOpEnableEXT       = nullptr;
+		PFN_vkCmdSetColorBlendEnableEXT vkCmdSetColorBlendEnableEXT = nullptr;
+		PFN_vkCmdSetColorBlendEquationEXT vkCmdSetColorBlendEquationEXT =
+		    nullptr;
+		PFN_vkCmdSetColorWriteMaskEXT vkCmdSetColorWriteMaskEXT = nullptr;
+		PFN_vkCmdSetSampleMaskEXT vkCmdSetSampleMaskEXT         = nullptr;
+
+		// VK_EXT_vertex_input_dynamic_state
+		PFN_vkCmdSetVertexInputEXT vkCmdSetVertexInputEXT = nullptr;
+
+		// VK_EXT_shader_object
+		PFN_vkCreateShadersEXT vkCreateShadersEXT   = nullptr;
+		PFN_vkDestroyShaderEXT vkDestroyShaderEXT   = nullptr;
+		PFN_vkCmdBindShadersEXT vkCmdBindShadersEXT = nullptr;
+
+		// VK_KHR_dynamic_rendering
+		PFN_vkCmdBeginRenderingKHR vkCmdBeginRenderingKHR = nullptr;
+		PFN_vkCmdEndRenderingKHR vkCmdEndRenderingKHR     = nullptr;
+	};
+} // namespace sat
+
+#endif
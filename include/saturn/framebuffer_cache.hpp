@@ -0,0 +1,82 @@
+#ifndef SATURN_FRAMEBUFFER_CACHE_HPP
+#define SATURN_FRAMEBUFFER_CACHE_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core.hpp"
+
+namespace sat
+{
+	class Device;
+
+	///////////////////////////
+	//// Framebuffer Cache ////
+	///////////////////////////
+
+	/**
+	 * \brief Device-owned cache of framebuffers keyed by their render pass,
+	 * views and extent. A framebuffer is dropped as soon as its render pass
+	 * or one of its views is destroyed, so swap chain and offscreen images
+	 * can be re-created without rebuilding framebuffers by hand.
+	 */
+	class SATURN_API FramebufferCache
+	{
+	public:
+		~FramebufferCache() noexcept;
+
+		FramebufferCache(const FramebufferCache&)            = delete;
+		FramebufferCache& operator=(const FramebufferCache&) = delete;
+
+		/**
+		 * \brief Returns the framebuffer of \p renderPass with \p views as
+		 * its attachments, in attachment order.
+		 */
+		VkFramebuffer get(VkRenderPass renderPass,
+		                  std::span<VkImageView const> views,
+		                  const VkExtent2D& extent);
+		VkFramebuffer get(VkRenderPass renderPass,
+		                  VkImageView view,
+		                  const VkExtent2D& extent);
+
+		/**
+		 * \brief Destroys every framebuffer using \p view once the current
+		 * frame has completed. Called when a view owned by saturn dies.
+		 */
+		void invalidateView(VkImageView view);
+
+		/**
+		 * \brief Destroys every framebuffer of \p renderPass once the
+		 * current frame has completed.
+		 */
+		void invalidateRenderPass(VkRenderPass renderPass);
+
+		size_t size() const;
+
+	private:
+		friend class Device;
+
+		struct Entry
+		{
+			VkFramebuffer framebuffer;
+			VkRenderPass renderPass;
+			std::vector<VkImageView> views;
+		};
+
+		explicit FramebufferCache(Device& device) noexcept;
+
+		template <typename F>
+		void drop(F&& predicate);
+
+		Device& device_;
+		std::unordered_map<std::string, Entry> framebuffers_;
+		mutable std::mutex mutex_;
+	};
+} // namespace sat
+
+#endif
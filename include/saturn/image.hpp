@@ -0,0 +1,99 @@
+#ifndef SATURN_IMAGE_HPP
+#define SATURN_IMAGE_HPP
+
+#include <vulkan/vulkan.h>
+
+#include "allocator.hpp"
+#include "core.hpp"
+
+namespace sat
+{
+	class Device;
+	class Image;
+
+	///////////////
+	//// Image ////
+	///////////////
+
+	namespace image
+	{
+		/**
+		 * \brief Aspects of \p format, which are depth and stencil for
+		 * depth/stencil formats and color for everything else.
+		 */
+		SATURN_API VkImageAspectFlags aspect(VkFormat format) noexcept;
+	} // namespace image
+
+	///////////////////////
+	//// Image Builder ////
+	///////////////////////
+
+	class SATURN_API ImageBuilder : public Builder<ImageBuilder, Image>
+	{
+	public:
+		explicit ImageBuilder(rn<Device> device) noexcept;
+
+		ImageBuilder& format(VkFormat format) noexcept;
+		ImageBuilder& extent(const VkExtent2D& extent) noexcept;
+		ImageBuilder& usage(VkImageUsageFlags usage) noexcept;
+		ImageBuilder& samples(VkSampleCountFlagBits samples) noexcept;
+
+		/**
+		 * \brief Marks the image as an attachment that is never read back
+		 * outside of the render pass using it, such as a depth buffer or a
+		 * multisampled target that gets resolved. Such images are backed by
+		 * lazily allocated memory when the device has it, so tiled GPUs can
+		 * keep them in on-chip memory only.
+		 */
+		ImageBuilder& transient() noexcept;
+
+	private:
+		friend class Image;
+
+		rn<Device> device_;
+		VkFormat format_               = VK_FORMAT_UNDEFINED;
+		VkExtent2D extent_{};
+		VkImageUsageFlags usage_       = 0;
+		VkSampleCountFlagBits samples_ = VK_SAMPLE_COUNT_1_BIT;
+		bool transient_                = false;
+	};
+
+	///////////////
+	//// Image ////
+	///////////////
+
+	/**
+	 * \brief 2D image with a single mip level and layer, and a view of all
+	 * of its aspects.
+	 */
+	class SATURN_API Image : public Container<VkImage>
+	{
+	public:
+		~Image() noexcept;
+
+		Image(const Image&)            = delete;
+		Image& operator=(const Image&) = delete;
+
+		VkImageView view() const noexcept { return view_; }
+
+		VkFormat format() const noexcept { return format_; }
+
+		const VkExtent2D& extent() const noexcept { return extent_; }
+
+		VkSampleCountFlagBits samples() const noexcept { return samples_; }
+
+	private:
+		friend class Builder<ImageBuilder, Image>;
+
+		explicit Image(const ImageBuilder& builder);
+
+		rn<Device> device_;
+		VmaAllocation allocation_;
+		VkImageView view_ = VK_NULL_HANDLE;
+		VkFormat format_;
+		VkExtent2D extent_;
+		VkSampleCountFlagBits samples_;
+	};
+} // namespace sat
+
+#endif
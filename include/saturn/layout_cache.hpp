@@ -0,0 +1,65 @@
+#ifndef SATURN_LAYOUT_CACHE_HPP
+#define SATURN_LAYOUT_CACHE_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+
+#include "core.hpp"
+
+namespace sat
+{
+	class Device;
+
+	//////////////////////
+	//// Layout Cache ////
+	//////////////////////
+
+	/**
+	 * \brief Device-owned cache of descriptor set layouts and pipeline
+	 * layouts, deduplicated by their contents. Equal layouts share one
+	 * handle, which keeps pipelines built from them compatible for
+	 * descriptor sets. Handles stay valid until the device is destroyed.
+	 */
+	class SATURN_API LayoutCache
+	{
+	public:
+		~LayoutCache() noexcept;
+
+		LayoutCache(const LayoutCache&)            = delete;
+		LayoutCache& operator=(const LayoutCache&) = delete;
+
+		/**
+		 * \brief Returns the set layout for \p bindings, in any order.
+		 *
+		 * \param flags Flags of each binding, or empty when none have any.
+		 */
+		VkDescriptorSetLayout descriptorLayout(
+		    std::span<VkDescriptorSetLayoutBinding const> bindings,
+		    std::span<VkDescriptorBindingFlags const> flags = {});
+
+		/**
+		 * \brief Returns the pipeline layout with the given set layouts, in
+		 * set order, and push constant ranges.
+		 */
+		VkPipelineLayout pipelineLayout(
+		    std::span<VkDescriptorSetLayout const> setLayouts,
+		    std::span<VkPushConstantRange const> pushConstants = {});
+
+	private:
+		friend class Device;
+
+		explicit LayoutCache(VkDevice device) noexcept;
+
+		VkDevice device_;
+		std::unordered_map<std::string, VkDescriptorSetLayout>
+		    descriptorLayouts_;
+		std::unordered_map<std::string, VkPipelineLayout> pipelineLayouts_;
+		std::mutex mutex_;
+	};
+} // namespace sat
+
+#endif
@@ -22,6 +22,8 @@ namespace sat
 		VkPhysicalDevice handle;
 		VkPhysicalDeviceProperties properties;
 		VkPhysicalDeviceFeatures features;
+		VkPhysicalDeviceVulkan11Features features11;
+		VkPhysicalDeviceVulkan12Features features12;
 		std::vector<VkQueueFamilyProperties> queueFamilies;
 		std::vector<VkExtensionProperties> extensions;
 	};
@@ -4,8 +4,12 @@
 #include <vulkan/vulkan.h>
 #include <vulkan/vulkan_core.h>
 
+#include <cstring>
 #include <optional>
 #include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "core.hpp"
@@ -16,7 +20,6 @@ namespace sat
 	class Device;
 	class Pipeline;
 	class Shader;
-	class Swapchain;
 
 	////////////////////////////
 	//// Vertex Description ////
@@ -52,6 +55,8 @@ namespace sat
 		}
 
 	private:
+		friend class PipelineManifest;
+
 		uint32_t nextBinding_ = 0;
 		uint32_t nextLocation_;
 
@@ -74,16 +79,140 @@ namespace sat
 		    uint32_t count                  = 1,
 		    std::optional<uint32_t> binding = std::nullopt) noexcept;
 
+		/**
+		 * \brief Adds an array of up to \p count descriptors that may be
+		 * partially bound and updated after being bound, for indexing from
+		 * shaders.
+		 */
+		DescriptorLayout& addBindless(
+		    VkDescriptorType type,
+		    VkShaderStageFlags stages,
+		    uint32_t count,
+		    std::optional<uint32_t> binding = std::nullopt) noexcept;
+
 		std::span<VkDescriptorSetLayoutBinding const> bindings() const noexcept
 		{
 			return bindings_;
 		}
 
+		std::span<VkDescriptorBindingFlags const> flags() const noexcept
+		{
+			return flags_;
+		}
+
 	private:
+		friend class PipelineManifest;
+
 		uint32_t nextBinding_ = 0;
 		std::vector<VkDescriptorSetLayoutBinding> bindings_;
+		std::vector<VkDescriptorBindingFlags> flags_;
 	};
 
+	////////////////////////
+	//// Specialization ////
+	////////////////////////
+
+	/**
+	 * \brief Values of a stage's specialization constants, which the driver
+	 * folds into the compiled shader.
+	 */
+	class SATURN_API Specialization
+	{
+	public:
+		Specialization() noexcept = default;
+
+		/**
+		 * \brief Sets constant \p id to \p value, which must match the size
+		 * of the constant declared in the shader.
+		 */
+		template <typename T>
+		    requires std::is_trivially_copyable_v<T>
+		Specialization& set(uint32_t id, const T& value) noexcept;
+
+		/**
+		 * \brief Sets a boolean constant, which shaders declare as 32 bits.
+		 */
+		Specialization& set(uint32_t id, bool value) noexcept
+		{
+			return set<VkBool32>(id, value ? VK_TRUE : VK_FALSE);
+		}
+
+		bool empty() const noexcept { return entries_.empty(); }
+
+		std::span<VkSpecializationMapEntry const> entries() const noexcept
+		{
+			return entries_;
+		}
+
+		std::span<uint8_t const> data() const noexcept { return data_; }
+
+		/**
+		 * \brief Describes the constants. Only valid while this object is
+		 * alive and unchanged.
+		 */
+		VkSpecializationInfo info() const noexcept;
+
+	private:
+		friend class PipelineManifest;
+
+		std::vector<VkSpecializationMapEntry> entries_;
+		std::vector<uint8_t> data_;
+	};
+
+	template <typename T>
+	    requires std::is_trivially_copyable_v<T>
+	inline Specialization& Specialization::set(uint32_t id,
+	                                           const T& value) noexcept
+	{
+		bool resized = false;
+
+		for (VkSpecializationMapEntry& entry : entries_)
+		{
+			if (entry.constantID == id && entry.size == sizeof(T))
+			{
+				std::memcpy(data_.data() + entry.offset, &value, sizeof(T));
+				return *this;
+			}
+
+			resized = resized || entry.constantID == id;
+		}
+
+		if (resized)
+		{
+			// Repack without the old bytes, which would otherwise still count
+			// towards the key of the pipeline
+			std::vector<VkSpecializationMapEntry> entries;
+			std::vector<uint8_t> data;
+			entries.reserve(entries_.size());
+			data.reserve(data_.size());
+
+			for (VkSpecializationMapEntry entry : entries_)
+			{
+				if (entry.constantID != id)
+				{
+					const uint8_t* pBytes = data_.data() + entry.offset;
+					entry.offset          = data.size();
+					data.insert(data.end(), pBytes, pBytes + entry.size);
+					entries.push_back(entry);
+				}
+			}
+
+			entries_ = std::move(entries);
+			data_    = std::move(data);
+		}
+
+		VkSpecializationMapEntry entry{};
+		entry.constantID = id;
+		entry.offset     = data_.size();
+		entry.size       = sizeof(T);
+
+		data_.resize(data_.size() + sizeof(T));
+		std::memcpy(data_.data() + entry.offset, &value, sizeof(T));
+		entries_.push_back(entry);
+
+		return *this;
+	}
+
 	//////////////////////////
 	//// Pipeline Builder ////
 	//////////////////////////
@@ -91,40 +220,200 @@ namespace sat
 	class SATURN_API PipelineBuilder : public Builder<PipelineBuilder, Pipeline>
 	{
 	public:
+		PipelineBuilder(rn<Device> device, rn<RenderPass> renderPass) noexcept;
+
+		/**
+		 * \brief Builds pipelines for dynamic rendering into attachments of
+		 * the given formats instead of a render pass. The device needs
+		 * VK_KHR_dynamic_rendering and its feature enabled.
+		 */
 		PipelineBuilder(rn<Device> device,
-		                rn<Swapchain> swapchain,
-		                rn<RenderPass> renderPass) noexcept;
+		                std::span<VkFormat const> colorFormats,
+		                VkFormat depthFormat = VK_FORMAT_UNDEFINED) noexcept;
 
 		PipelineBuilder& addStage(VkShaderStageFlagBits stage,
 		                          rn<Shader> shader,
-		                          const char* pEntrypoint = "main") noexcept;
-
+		                          const char* pEntrypoint = "main",
+		                          const Specialization& specialization =
+		                              {}) noexcept;
+
+		/**
+		 * \brief Leaves \p state to be set while recording. Viewport and
+		 * scissor are always dynamic, so the pipeline isn't tied to an
+		 * extent.
+		 */
 		PipelineBuilder& addDynamicState(VkDynamicState state) noexcept;
 
 		PipelineBuilder& topology(VkPrimitiveTopology topology) noexcept;
 		PipelineBuilder& polygonMode(VkPolygonMode polygonMode) noexcept;
+		PipelineBuilder& cullMode(VkCullModeFlags cullMode) noexcept;
 		PipelineBuilder& frontFace(VkFrontFace frontFace) noexcept;
 		PipelineBuilder& subpass(uint32_t subpass) noexcept;
+
+		/**
+		 * \brief Samples per pixel, which must match the attachments
+		 * rendered to.
+		 */
+		PipelineBuilder& samples(VkSampleCountFlagBits samples) noexcept;
+
+		/**
+		 * \brief Tests fragments against the depth attachment with
+		 * \p compareOp, and writes their depth when \p write is set.
+		 */
+		PipelineBuilder& depthTest(VkCompareOp compareOp = VK_COMPARE_OP_LESS,
+		                           bool write            = true) noexcept;
+
+		/**
+		 * \brief Names the pipeline in the device's \ref PipelineStats.
+		 * Doesn't affect the key.
+		 */
+		PipelineBuilder& name(std::string name) noexcept;
 		PipelineBuilder& vertexDescription(
 		    const VertexDescription& description) noexcept;
-		PipelineBuilder& descriptorLayout(
-		    const DescriptorLayout& layout) noexcept;
+
+		/**
+		 * \brief Sets the layout of descriptor set \p set. Sets without a
+		 * layout below the highest one are left empty.
+		 */
+		PipelineBuilder& descriptorLayout(const DescriptorLayout& layout,
+		                                  uint32_t set = 0) noexcept;
+
+		/**
+		 * \brief Declares push constants read by \p stages. Ranges past the
+		 * device's maxPushConstantsSize make building throw.
+		 */
+		PipelineBuilder& pushConstantRange(VkShaderStageFlags stages,
+		                                   uint32_t size,
+		                                   uint32_t offset = 0) noexcept;
+
+		/**
+		 * \brief Declares push constants laid out as \p T.
+		 */
+		template <typename T>
+		    requires std::is_trivially_copyable_v<T>
+		PipelineBuilder& pushConstant(VkShaderStageFlags stages,
+		                              uint32_t offset = 0) noexcept
+		{
+			static_assert(sizeof(T) % 4 == 0,
+			              "Push constant size must be a multiple of 4");
+			return pushConstantRange(stages, sizeof(T), offset);
+		}
+
+		/**
+		 * \brief Derives the descriptor layouts, push constant range and
+		 * vertex description from the stages added so far. Sets that already
+		 * have a layout are kept, as are push constant ranges and a vertex
+		 * description set by hand. Vertex inputs are read from a single
+		 * interleaved binding, packed in order of location.
+		 */
+		PipelineBuilder& reflect();
+
+		/**
+		 * \brief Encodes the full state of the builder. Builders with equal
+		 * keys produce identical pipelines.
+		 */
+		std::string key() const;
 
 	private:
 		friend class Pipeline;
+		friend class PipelineLibrary;
+		friend class PipelineManifest;
+		friend class ShaderWatcher;
+
+		/**
+		 * \brief Encodes only the state that affects the given library
+		 * \p parts, or all of it when empty.
+		 */
+		std::string key(VkGraphicsPipelineLibraryFlagsEXT parts) const;
+
+		/**
+		 * \brief Drops the state \ref reflect derived and derives it again,
+		 * for when the shaders have changed.
+		 */
+		void reflectAgain();
+
+		bool dynamic(VkDynamicState state) const noexcept;
 
 		rn<Device> device_;
-		rn<Swapchain> swapchain_;
 		rn<RenderPass> renderPass_;
+		std::vector<VkFormat> colorFormats_;
+		VkFormat depthFormat_ = VK_FORMAT_UNDEFINED;
 		std::vector<VkPipelineShaderStageCreateInfo> stages_;
+		std::vector<Specialization> specializations_;
 		std::vector<rn<Shader>> shaders_;
 		std::vector<VkDynamicState> dynamics_;
-		VkPrimitiveTopology topology_ = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-		VkPolygonMode polygonMode_    = VK_POLYGON_MODE_FILL;
-		VkFrontFace frontFace_        = VK_FRONT_FACE_CLOCKWISE;
-		uint32_t subpass_             = 0;
+		VkPrimitiveTopology topology_  = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+		VkPolygonMode polygonMode_     = VK_POLYGON_MODE_FILL;
+		VkCullModeFlags cullMode_      = VK_CULL_MODE_BACK_BIT;
+		VkFrontFace frontFace_         = VK_FRONT_FACE_CLOCKWISE;
+		uint32_t subpass_              = 0;
+		VkSampleCountFlagBits samples_ = VK_SAMPLE_COUNT_1_BIT;
+		bool depthTest_                = false;
+		bool depthWrite_               = false;
+		VkCompareOp depthCompareOp_    = VK_COMPARE_OP_LESS;
 		VertexDescription description_;
-		DescriptorLayout layout_;
+		std::vector<DescriptorLayout> layouts_;
+		std::vector<VkPushConstantRange> pushConstants_;
+		std::string name_;
+
+		// State filled in by reflect() rather than by hand
+		bool reflected_ = false;
+		std::vector<uint32_t> reflectedSets_;
+		bool reflectedPushConstants_ = false;
+		bool reflectedDescription_   = false;
+	};
+
+	//////////////////////////////////
+	//// Compute Pipeline Builder ////
+	//////////////////////////////////
+
+	class SATURN_API ComputePipelineBuilder
+	    : public Builder<ComputePipelineBuilder, Pipeline>
+	{
+	public:
+		explicit ComputePipelineBuilder(rn<Device> device) noexcept;
+
+		ComputePipelineBuilder& shader(
+		    rn<Shader> shader,
+		    const char* pEntrypoint              = "main",
+		    const Specialization& specialization = {}) noexcept;
+
+		ComputePipelineBuilder& descriptorLayout(const DescriptorLayout& layout,
+		                                         uint32_t set = 0) noexcept;
+
+		ComputePipelineBuilder& name(std::string name) noexcept;
+
+		/**
+		 * \brief Derives the descriptor layouts and push constant range from
+		 * the shader. Sets that already have a layout are kept, as are push
+		 * constant ranges set by hand.
+		 */
+		ComputePipelineBuilder& reflect();
+
+		ComputePipelineBuilder& pushConstantRange(VkShaderStageFlags stages,
+		                                          uint32_t size,
+		                                          uint32_t offset = 0) noexcept;
+
+		template <typename T>
+		    requires std::is_trivially_copyable_v<T>
+		ComputePipelineBuilder& pushConstant(VkShaderStageFlags stages,
+		                                     uint32_t offset = 0) noexcept
+		{
+			static_assert(sizeof(T) % 4 == 0,
+			              "Push constant size must be a multiple of 4");
+			return pushConstantRange(stages, sizeof(T), offset);
+		}
+
+	private:
+		friend class Pipeline;
+
+		rn<Device> device_;
+		rn<Shader> shader_;
+		const char* pEntrypoint_ = "main";
+		Specialization specialization_;
+		std::vector<DescriptorLayout> layouts_;
+		std::vector<VkPushConstantRange> pushConstants_;
+		std::string name_;
 	};
 
 	//////////////////
@@ -139,16 +428,46 @@ namespace sat
 		Pipeline(const Pipeline&)            = delete;
 		Pipeline& operator=(const Pipeline&) = delete;
 
+		/**
+		 * \brief Shared layout, equal for every pipeline built with the same
+		 * descriptor layouts and push constant ranges.
+		 */
+		VkPipelineLayout layout() const noexcept { return pipelineLayout_; }
+
+		VkDescriptorSetLayout descriptorLayout(uint32_t set = 0) const
+		{
+			return descriptorLayouts_.at(set);
+		}
+
+		VkPipelineBindPoint bindPoint() const noexcept { return bindPoint_; }
+
 	private:
 		friend class Builder<PipelineBuilder, Pipeline>;
+		friend class Builder<ComputePipelineBuilder, Pipeline>;
+		friend class PipelineLibrary;
 
 		explicit Pipeline(const PipelineBuilder& builder);
 
+		/**
+		 * \brief Creates a pipeline library holding \p parts of the
+		 * builder's state, links \p libraries into a complete pipeline, or
+		 * creates a complete pipeline when both are empty.
+		 */
+		Pipeline(const PipelineBuilder& builder,
+		         VkGraphicsPipelineLibraryFlagsEXT parts,
+		         std::span<VkPipeline const> libraries,
+		         VkPipelineCreateFlags flags);
+		explicit Pipeline(const ComputePipelineBuilder& builder);
+
+		void createLayouts(std::span<DescriptorLayout const> layouts,
+		                   std::span<VkPushConstantRange const> pushConstants);
+
 		rn<Device> device_;
-		rn<Swapchain> swapchain_;
 		rn<RenderPass> renderPass_;
-		VkDescriptorSetLayout descriptorLayout_;
+		std::vector<rn<Shader>> shaders_;
+		std::vector<VkDescriptorSetLayout> descriptorLayouts_;
 		VkPipelineLayout pipelineLayout_;
+		VkPipelineBindPoint bindPoint_;
 	};
 } // namespace sat
 
@@ -0,0 +1,73 @@
+#ifndef SATURN_PIPELINE_CACHE_HPP
+#define SATURN_PIPELINE_CACHE_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <filesystem>
+#include <shared_mutex>
+#include <span>
+
+#include "core.hpp"
+#include "physical_device.hpp"
+
+namespace sat
+{
+	class Device;
+
+	////////////////////////
+	//// Pipeline Cache ////
+	////////////////////////
+
+	/**
+	 * \brief Device-owned \ref VkPipelineCache that is loaded from and saved
+	 * to a file, so pipelines compiled by one run are reused by the next.
+	 */
+	class SATURN_API PipelineCache : public Container<VkPipelineCache>
+	{
+	public:
+		~PipelineCache() noexcept;
+
+		PipelineCache(const PipelineCache&)            = delete;
+		PipelineCache& operator=(const PipelineCache&) = delete;
+
+		/**
+		 * \brief Creates an empty cache for use by a single thread, to be
+		 * folded back with \ref merge().
+		 */
+		VkPipelineCache fork() const;
+
+		/**
+		 * \brief Merges the given caches into this one and destroys them.
+		 * Waits for pipelines being created with the cache, as merging needs
+		 * it to itself.
+		 */
+		void merge(std::span<VkPipelineCache const> caches);
+
+		/**
+		 * \brief Lock to hold while creating pipelines with the cache, which
+		 * keeps \ref merge() from running at the same time.
+		 */
+		std::shared_lock<std::shared_mutex> use() const;
+
+		/**
+		 * \brief Writes the cache to its file by replacing it with a fully
+		 * written temporary, so a crash never leaves a truncated cache.
+		 */
+		void save();
+
+		const std::filesystem::path& path() const noexcept { return path_; }
+
+	private:
+		friend class Device;
+
+		PipelineCache(VkDevice device,
+		              const PhysicalDevice& physicalDevice,
+		              std::filesystem::path path);
+
+		VkDevice device_;
+		std::filesystem::path path_;
+		mutable std::shared_mutex mutex_;
+	};
+} // namespace sat
+
+#endif
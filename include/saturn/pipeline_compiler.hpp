@@ -0,0 +1,55 @@
+#ifndef SATURN_PIPELINE_COMPILER_HPP
+#define SATURN_PIPELINE_COMPILER_HPP
+
+#include <future>
+#include <span>
+#include <vector>
+
+#include "core.hpp"
+#include "pipeline.hpp"
+#include "thread_pool.hpp"
+
+namespace sat
+{
+	///////////////////////////
+	//// Pipeline Compiler ////
+	///////////////////////////
+
+	/**
+	 * \brief Compiles pipelines on a pool of worker threads. Every worker
+	 * compiles against the device's pipeline cache.
+	 */
+	class SATURN_API PipelineCompiler
+	{
+	public:
+		/**
+		 * \brief Starts a \ref ThreadPool of \p threads workers.
+		 */
+		explicit PipelineCompiler(unsigned threads = 0);
+
+		PipelineCompiler(const PipelineCompiler&)            = delete;
+		PipelineCompiler& operator=(const PipelineCompiler&) = delete;
+
+		/**
+		 * \brief Queues a pipeline for compilation.
+		 *
+		 * \return Future that becomes valid once the pipeline is built.
+		 */
+		std::future<rn<Pipeline>> compile(PipelineBuilder builder);
+
+		/**
+		 * \brief Queues every pipeline for compilation at once.
+		 *
+		 * \return Futures in the same order as \p builders.
+		 */
+		std::vector<std::future<rn<Pipeline>>> compile(
+		    std::span<PipelineBuilder const> builders);
+
+		ThreadPool& pool() noexcept { return pool_; }
+
+	private:
+		ThreadPool pool_;
+	};
+} // namespace sat
+
+#endif
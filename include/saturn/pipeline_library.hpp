@@ -0,0 +1,89 @@
+#ifndef SATURN_PIPELINE_LIBRARY_HPP
+#define SATURN_PIPELINE_LIBRARY_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core.hpp"
+#include "pipeline.hpp"
+#include "thread_pool.hpp"
+
+namespace sat
+{
+	class Device;
+	class PipelineManifest;
+
+	//////////////////////////
+	//// Pipeline Library ////
+	//////////////////////////
+
+	/**
+	 * \brief Builds graphics pipelines from cached parts with
+	 * VK_EXT_graphics_pipeline_library. The vertex input, pre-rasterization,
+	 * fragment shader and fragment output parts are compiled once and shared
+	 * between pipelines, so a new combination only costs a fast link. An
+	 * optimized pipeline is compiled in the background and replaces the
+	 * fast one for later requests.
+	 *
+	 * The device needs VK_KHR_pipeline_library, the extension and its
+	 * graphicsPipelineLibrary feature enabled, otherwise pipelines are
+	 * created whole.
+	 */
+	class SATURN_API PipelineLibrary
+	{
+	public:
+		/**
+		 * \brief Compiles optimized pipelines on a \ref ThreadPool of
+		 * \p threads workers.
+		 */
+		explicit PipelineLibrary(rn<Device> device, unsigned threads = 0);
+		~PipelineLibrary() noexcept;
+
+		PipelineLibrary(const PipelineLibrary&)            = delete;
+		PipelineLibrary& operator=(const PipelineLibrary&) = delete;
+
+		/**
+		 * \brief Returns the pipeline for the builder's state, linking it
+		 * from cached parts the first time. Safe to call from several threads
+		 * at once.
+		 */
+		rn<Pipeline> get(const PipelineBuilder& builder);
+
+		/**
+		 * \brief Records the state of every pipeline linked from now on into
+		 * \p pManifest, or stops recording when null.
+		 */
+		void record(PipelineManifest* pManifest) noexcept;
+
+		bool supported() const noexcept { return supported_; }
+
+		/**
+		 * \brief Why optimized links have failed, in which case the fast
+		 * linked pipelines are kept.
+		 */
+		std::vector<std::string> errors() const;
+
+	private:
+		rn<Pipeline> part(const PipelineBuilder& builder,
+		                  VkGraphicsPipelineLibraryFlagsEXT part);
+
+		rn<Device> device_;
+		bool supported_;
+		std::unordered_map<std::string, rn<Pipeline>> parts_;
+		std::unordered_map<std::string, rn<Pipeline>> pipelines_;
+		PipelineManifest* pManifest_ = nullptr;
+		std::vector<std::string> errors_;
+		mutable std::mutex mutex_;
+		std::atomic<bool> stopping_ = false;
+
+		// Workers must stop before the maps they write to are destroyed
+		ThreadPool pool_;
+	};
+} // namespace sat
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef SATURN_PIPELINE_MANIFEST_HPP
+#define SATURN_PIPELINE_MANIFEST_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "core.hpp"
+#include "pipeline.hpp"
+
+namespace sat
+{
+	class Device;
+	class PipelineCompiler;
+	class PipelineRegistry;
+	class RenderPass;
+	class Shader;
+
+	///////////////////////////
+	//// Pipeline Manifest ////
+	///////////////////////////
+
+	/**
+	 * \brief Pipeline states requested during a run, saved to a compact
+	 * binary file so the next run can compile them before the first frame.
+	 *
+	 * Shaders and render passes can't be saved, so they are referred to by
+	 * the names they are registered under. States using anything that isn't
+	 * registered are neither recorded nor compiled.
+	 *
+	 * States are recorded by a \ref PipelineRegistry or \ref PipelineLibrary
+	 * set to record into the manifest. Compute pipelines are built without
+	 * either, so they are never recorded.
+	 */
+	class SATURN_API PipelineManifest
+	{
+	public:
+		explicit PipelineManifest(rn<Device> device) noexcept;
+
+		PipelineManifest(const PipelineManifest&)            = delete;
+		PipelineManifest& operator=(const PipelineManifest&) = delete;
+
+		PipelineManifest& shader(std::string name, rn<Shader> shader);
+		PipelineManifest& renderPass(std::string name,
+		                             rn<RenderPass> renderPass);
+
+		/**
+		 * \brief Adds the state of \p builder. Safe to call from several
+		 * threads at once.
+		 *
+		 * \return Whether the state could be recorded.
+		 */
+		bool record(const PipelineBuilder& builder);
+
+		/**
+		 * \brief Writes every recorded state by replacing the file with a
+		 * fully written temporary.
+		 */
+		void save(const std::filesystem::path& path) const;
+
+		/**
+		 * \brief Adds the states saved in \p path.
+		 *
+		 * \return False when the file is missing or unreadable, in which case
+		 * nothing is added.
+		 */
+		bool load(const std::filesystem::path& path);
+
+		/**
+		 * \brief Compiles every state through \p registry on the workers of
+		 * \p compiler and waits for all of them, so later requests for the
+		 * same states return immediately.
+		 *
+		 * \return Number of pipelines compiled.
+		 */
+		size_t compile(PipelineCompiler& compiler,
+		               PipelineRegistry& registry) const;
+
+		size_t size() const;
+
+	private:
+		std::optional<std::string> serialize(
+		    const PipelineBuilder& builder) const;
+		std::optional<PipelineBuilder> deserialize(
+		    std::string_view bytes) const;
+
+		rn<Device> device_;
+		std::unordered_map<std::string, rn<Shader>> shaders_;
+		std::unordered_map<VkShaderModule, std::string> shaderNames_;
+		std::unordered_map<std::string, rn<RenderPass>> renderPasses_;
+		std::unordered_map<VkRenderPass, std::string> renderPassNames_;
+
+		/**
+		 * \brief Entrypoint names of loaded states, which builders point to.
+		 */
+		mutable std::set<std::string, std::less<>> entrypoints_;
+
+		std::unordered_set<std::string> states_;
+		mutable std::mutex mutex_;
+	};
+} // namespace sat
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef SATURN_PIPELINE_REGISTRY_HPP
+#define SATURN_PIPELINE_REGISTRY_HPP
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "core.hpp"
+#include "pipeline.hpp"
+
+namespace sat
+{
+	class PipelineManifest;
+
+	///////////////////////////
+	//// Pipeline Registry ////
+	///////////////////////////
+
+	/**
+	 * \brief Deduplicates pipelines by the key of their builder, so requesting
+	 * the same state twice returns the same pipeline.
+	 */
+	class SATURN_API PipelineRegistry
+	{
+	public:
+		PipelineRegistry() = default;
+
+		PipelineRegistry(const PipelineRegistry&)            = delete;
+		PipelineRegistry& operator=(const PipelineRegistry&) = delete;
+
+		/**
+		 * \brief Returns the pipeline built from an equal state, or builds it.
+		 * Safe to call from several threads at once.
+		 */
+		rn<Pipeline> get(const PipelineBuilder& builder);
+
+		/**
+		 * \brief Drops every pipeline that is only referenced by the registry.
+		 */
+		void prune();
+
+		void clear();
+
+		/**
+		 * \brief Records the state of every pipeline built from now on into
+		 * \p pManifest, or stops recording when null.
+		 */
+		void record(PipelineManifest* pManifest) noexcept;
+
+		size_t size() const;
+
+	private:
+		std::unordered_map<std::string, rn<Pipeline>> pipelines_;
+		PipelineManifest* pManifest_ = nullptr;
+		mutable std::mutex mutex_;
+	};
+} // namespace sat
+
+#endif
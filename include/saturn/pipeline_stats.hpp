@@ -0,0 +1,90 @@
+#ifndef SATURN_PIPELINE_STATS_HPP
+#define SATURN_PIPELINE_STATS_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "core.hpp"
+
+namespace sat
+{
+	class Device;
+
+	///////////////////////////
+	//// Pipeline Feedback ////
+	///////////////////////////
+
+	/**
+	 * \brief How long one pipeline took to create and whether the pipeline
+	 * cache already held it.
+	 */
+	struct PipelineFeedback
+	{
+		struct Stage
+		{
+			VkShaderStageFlagBits stage;
+			uint64_t duration;
+			std::optional<bool> cacheHit;
+		};
+
+		std::string name;
+		VkPipelineBindPoint bindPoint;
+
+		/**
+		 * \brief Nanoseconds reported by the driver, or measured around the
+		 * create call when it reported nothing.
+		 */
+		uint64_t duration;
+
+		/**
+		 * \brief Empty when the driver gave no creation feedback.
+		 */
+		std::optional<bool> cacheHit;
+
+		std::vector<Stage> stages;
+	};
+
+	////////////////////////
+	//// Pipeline Stats ////
+	////////////////////////
+
+	/**
+	 * \brief Device-owned record of every pipeline created, for finding the
+	 * ones worth precompiling or simplifying. Driver feedback is only
+	 * available with VK_EXT_pipeline_creation_feedback enabled.
+	 */
+	class SATURN_API PipelineStats
+	{
+	public:
+		PipelineStats(const PipelineStats&)            = delete;
+		PipelineStats& operator=(const PipelineStats&) = delete;
+
+		void record(PipelineFeedback feedback);
+
+		std::vector<PipelineFeedback> feedback() const;
+
+		size_t size() const;
+
+		void clear() noexcept;
+
+		/**
+		 * \brief Writes one line per pipeline, slowest first.
+		 */
+		void dump(std::ostream& out) const;
+
+	private:
+		friend class Device;
+
+		PipelineStats() noexcept = default;
+
+		mutable std::mutex mutex_;
+		std::vector<PipelineFeedback> feedback_;
+	};
+} // namespace sat
+
+#endif
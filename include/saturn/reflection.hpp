@@ -0,0 +1,74 @@
+#ifndef SATURN_REFLECTION_HPP
+#define SATURN_REFLECTION_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "core.hpp"
+
+namespace sat
+{
+	///////////////////////////
+	//// Shader Reflection ////
+	///////////////////////////
+
+	/**
+	 * \brief Interface of a shader module as declared in its SPIR-V.
+	 */
+	struct ShaderReflection
+	{
+		struct Input
+		{
+			uint32_t location;
+			VkFormat format;
+			uint32_t size;
+		};
+
+		struct Binding
+		{
+			uint32_t set;
+			uint32_t binding;
+			VkDescriptorType type;
+
+			/**
+			 * \brief Number of descriptors, or zero for runtime-sized arrays.
+			 */
+			uint32_t count;
+		};
+
+		/**
+		 * \brief Stage of the first entry point.
+		 */
+		VkShaderStageFlagBits stage = VK_SHADER_STAGE_ALL;
+
+		/**
+		 * \brief User-defined stage inputs by location. Matrices and arrays
+		 * take one location per column or element.
+		 */
+		std::vector<Input> inputs;
+
+		std::vector<Binding> bindings;
+
+		/**
+		 * \brief Bytes of push constants read, or zero when there are none.
+		 */
+		uint32_t pushConstantSize = 0;
+
+		std::array<uint32_t, 3> workgroupSize = {1, 1, 1};
+	};
+
+	namespace spirv
+	{
+		/**
+		 * \brief Reflects the interface of all global variables in \p code,
+		 * whether or not an entry point uses them.
+		 */
+		SATURN_API ShaderReflection reflect(std::span<uint32_t const> code);
+	} // namespace spirv
+} // namespace sat
+
+#endif
@@ -4,6 +4,8 @@
 #include <vulkan/vulkan.h>
 
 #include <list>
+#include <optional>
+#include <string>
 #include <vector>
 
 #include "core.hpp"
@@ -23,7 +25,36 @@ namespace sat
 	public:
 		explicit RenderPassBuilder(rn<Device> device) noexcept;
 
-		RenderPassBuilder& createColorAttachment(VkFormat format) noexcept;
+		/**
+		 * \brief Describes an attachment with full control over its
+		 * operations and layouts.
+		 */
+		RenderPassBuilder& createAttachment(
+		    const VkAttachmentDescription& attachment) noexcept;
+
+		/**
+		 * \brief Describes a color attachment. By default it is cleared and
+		 * kept for presenting.
+		 */
+		RenderPassBuilder& createColorAttachment(
+		    VkFormat format,
+		    VkAttachmentLoadOp loadOp     = VK_ATTACHMENT_LOAD_OP_CLEAR,
+		    VkAttachmentStoreOp storeOp   = VK_ATTACHMENT_STORE_OP_STORE,
+		    VkImageLayout finalLayout     = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+		    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT) noexcept;
+
+		/**
+		 * \brief Describes a depth/stencil attachment. By default it is
+		 * cleared and discarded after the pass, which suits transient
+		 * images. The stencil aspect, if any, uses the same operations.
+		 */
+		RenderPassBuilder& createDepthAttachment(
+		    VkFormat format,
+		    VkAttachmentLoadOp loadOp   = VK_ATTACHMENT_LOAD_OP_CLEAR,
+		    VkAttachmentStoreOp storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+		    VkImageLayout finalLayout =
+		        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+		    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT) noexcept;
 
 		RenderPassBuilder& begin(VkPipelineBindPoint bind =
 		                             VK_PIPELINE_BIND_POINT_GRAPHICS) noexcept;
@@ -34,6 +65,30 @@ namespace sat
 		    VkImageLayout layout =
 		        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL) noexcept;
 
+		/**
+		 * \brief Resolves the color attachment at the same position in the
+		 * subpass into attachment \p index at the end of the subpass.
+		 */
+		RenderPassBuilder& addResolveAttachment(
+		    uint32_t index,
+		    VkImageLayout layout =
+		        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL) noexcept;
+
+		RenderPassBuilder& depthAttachment(
+		    uint32_t index,
+		    VkImageLayout layout =
+		        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL) noexcept;
+
+		RenderPassBuilder& addDependency(
+		    const VkSubpassDependency& dependency) noexcept;
+
+		/**
+		 * \brief Encodes the device, attachments, subpasses and dependencies
+		 * of the builder. Builders with equal keys produce compatible render
+		 * passes.
+		 */
+		std::string key() const;
+
 	private:
 		friend class RenderPass;
 
@@ -55,6 +110,10 @@ namespace sat
 		 * subpass
 		 */
 		std::vector<VkAttachmentReference> colorAttachments_;
+		std::vector<VkAttachmentReference> resolveAttachments_;
+		std::optional<VkAttachmentReference> depthAttachment_;
+
+		std::vector<VkSubpassDependency> dependencies_;
 	};
 
 	/////////////////////
@@ -0,0 +1,51 @@
+#ifndef SATURN_RENDER_PASS_CACHE_HPP
+#define SATURN_RENDER_PASS_CACHE_HPP
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "core.hpp"
+#include "render_pass.hpp"
+
+namespace sat
+{
+	///////////////////////////
+	//// Render Pass Cache ////
+	///////////////////////////
+
+	/**
+	 * \brief Deduplicates render passes by the key of their builder, so equal
+	 * attachment and subpass descriptions share one render pass along with
+	 * its cached framebuffers and the pipelines built against it.
+	 */
+	class SATURN_API RenderPassCache
+	{
+	public:
+		RenderPassCache() = default;
+
+		RenderPassCache(const RenderPassCache&)            = delete;
+		RenderPassCache& operator=(const RenderPassCache&) = delete;
+
+		/**
+		 * \brief Returns the render pass built from an equal description, or
+		 * builds it.
+		 */
+		rn<RenderPass> get(const RenderPassBuilder& builder);
+
+		/**
+		 * \brief Drops every render pass that is only referenced by the cache.
+		 */
+		void prune();
+
+		void clear();
+
+		size_t size() const;
+
+	private:
+		std::unordered_map<std::string, rn<RenderPass>> renderPasses_;
+		mutable std::mutex mutex_;
+	};
+} // namespace sat
+
+#endif
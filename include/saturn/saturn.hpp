@@ -2,18 +2,36 @@
 #define SATURN_HPP
 
 #include "allocator.hpp"
+#include "bindless.hpp"
 #include "buffer.hpp"
 #include "command.hpp"
 #include "core.hpp"
+#include "descriptor.hpp"
+#include "descriptor_template.hpp"
 #include "device.hpp"
+#include "dispatch.hpp"
 #include "error.hpp"
 #include "framebuffer.hpp"
+#include "framebuffer_cache.hpp"
+#include "image.hpp"
 #include "instance.hpp"
+#include "layout_cache.hpp"
 #include "physical_device.hpp"
 #include "pipeline.hpp"
+#include "pipeline_cache.hpp"
+#include "pipeline_compiler.hpp"
+#include "pipeline_library.hpp"
+#include "pipeline_manifest.hpp"
+#include "pipeline_registry.hpp"
+#include "pipeline_stats.hpp"
+#include "reflection.hpp"
 #include "render_pass.hpp"
+#include "render_pass_cache.hpp"
 #include "shader.hpp"
+#include "shader_object.hpp"
+#include "shader_watcher.hpp"
 #include "swapchain.hpp"
 #include "sync.hpp"
+#include "thread_pool.hpp"
 
 #endif
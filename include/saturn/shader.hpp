@@ -5,15 +5,22 @@
 #include <vulkan/vulkan_core.h>
 
 #include <cstdint>
+#include <exception>
 #include <filesystem>
 #include <istream>
+#include <mutex>
 #include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "core.hpp"
+#include "reflection.hpp"
 
 namespace sat
 {
 	class Device;
+	class ThreadPool;
 
 	///////////////////////
 	//// Shader Loader ////
@@ -21,17 +28,90 @@ namespace sat
 
 	class Shader;
 
+	/**
+	 * \brief Creates shader modules, sharing one module between every load
+	 * of the same SPIR-V so the driver only parses it once.
+	 */
 	class SATURN_API ShaderLoader
 	{
 	public:
-		ShaderLoader(sat::rn<Device> device) noexcept;
-
+		/**
+		 * \param keepCode Keeps a copy of the SPIR-V of every module, which
+		 * shader objects are created from. Modules loaded from words always
+		 * refer to them instead.
+		 */
+		ShaderLoader(sat::rn<Device> device, bool keepCode = false) noexcept;
+
+		ShaderLoader(const ShaderLoader&)            = delete;
+		ShaderLoader& operator=(const ShaderLoader&) = delete;
+
+		/**
+		 * \brief Maps the file into memory and creates the module straight
+		 * from the mapping.
+		 */
 		sat::rn<Shader> fromFile(const std::filesystem::path& path) const;
 		sat::rn<Shader> fromStream(std::istream&& stream) const;
+
+		/**
+		 * \brief Creates a module from SPIR-V, copying it only when it isn't
+		 * aligned to 4 bytes.
+		 */
 		sat::rn<Shader> fromBytes(std::span<uint8_t const> bytes) const;
 
+		/**
+		 * \brief Creates a module from SPIR-V words without copying them,
+		 * such as the arrays embedded by saturn_embed_shaders(). The words
+		 * must outlive the module.
+		 */
+		sat::rn<Shader> fromBytes(std::span<uint32_t const> words) const;
+
+		/**
+		 * \brief Loads every .spv file under \p directory on the workers of
+		 * \p pool.
+		 *
+		 * \return Shaders by their path relative to \p directory, with
+		 * forward slashes.
+		 */
+		std::unordered_map<std::string, sat::rn<Shader>> fromDirectory(
+		    const std::filesystem::path& directory, ThreadPool& pool) const;
+
+		/**
+		 * \brief File that \p shader was first loaded from, or an empty path
+		 * when it wasn't loaded from a file.
+		 */
+		std::filesystem::path path(const Shader& shader) const;
+
+		/**
+		 * \brief Drops every module that is only referenced by the loader.
+		 */
+		void prune();
+
+		void clear();
+
+		size_t size() const;
+
 	private:
+		struct Entry
+		{
+			uint64_t check;
+			sat::rn<Shader> shader;
+		};
+
+		/**
+		 * \brief Returns the cached module for \p pBinary, or creates it.
+		 *
+		 * \param borrow Whether \p pBinary outlives the module.
+		 */
+		sat::rn<Shader> create(const uint32_t* pBinary,
+		                       size_t byteSize,
+		                       bool borrow = false) const;
+
 		sat::rn<Device> device_;
+		bool keepCode_;
+		mutable std::unordered_map<uint64_t, Entry> shaders_;
+		mutable std::unordered_map<VkShaderModule, std::filesystem::path>
+		    paths_;
+		mutable std::mutex mutex_;
 	};
 
 	////////////////
@@ -46,14 +126,37 @@ namespace sat
 		Shader(const Shader&)            = delete;
 		Shader& operator=(const Shader&) = delete;
 
+		/**
+		 * \brief Interface declared by the SPIR-V, read when the module was
+		 * created. Throws when the SPIR-V couldn't be reflected, which
+		 * doesn't keep the module itself from being used.
+		 */
+		const ShaderReflection& reflection() const;
+
+		/**
+		 * \brief SPIR-V the module was created from, which shader objects
+		 * are created from in turn. Empty unless its loader keeps code or
+		 * it was loaded from words.
+		 */
+		std::span<uint32_t const> code() const noexcept { return code_; }
+
 	private:
 		friend class ShaderLoader;
 
+		/**
+		 * \param code Kept as is when borrowed, copied when \p keep is set
+		 * and dropped otherwise.
+		 */
 		Shader(sat::rn<Device> device,
-		       const uint32_t* pBinary,
-		       size_t byteSize);
+		       std::span<uint32_t const> code,
+		       bool borrow,
+		       bool keep);
 
 		sat::rn<Device> device_;
+		ShaderReflection reflection_;
+		std::exception_ptr reflectionError_;
+		std::vector<uint32_t> storage_;
+		std::span<uint32_t const> code_;
 	};
 } // namespace sat
 
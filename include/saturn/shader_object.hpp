@@ -0,0 +1,141 @@
+#ifndef SATURN_SHADER_OBJECT_HPP
+#define SATURN_SHADER_OBJECT_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "core.hpp"
+#include "pipeline.hpp"
+
+namespace sat
+{
+	class Device;
+	class Shader;
+	class ShaderObject;
+
+	///////////////////////////////
+	//// Shader Object Builder ////
+	///////////////////////////////
+
+	class SATURN_API ShaderObjectBuilder
+	    : public Builder<ShaderObjectBuilder, ShaderObject>
+	{
+	public:
+		explicit ShaderObjectBuilder(rn<Device> device) noexcept;
+
+		/**
+		 * \brief Adds a stage created from the SPIR-V of \p shader, which
+		 * must have kept its code. Unlinked stages may be bound with any
+		 * later stage the device supports.
+		 */
+		ShaderObjectBuilder& addStage(VkShaderStageFlagBits stage,
+		                              rn<Shader> shader,
+		                              const char* pEntrypoint = "main",
+		                              const Specialization& specialization =
+		                                  {}) noexcept;
+
+		/**
+		 * \brief Compiles the stages together, which lets the driver
+		 * optimize across them. Linked stages must always be bound
+		 * together.
+		 */
+		ShaderObjectBuilder& link() noexcept;
+
+		ShaderObjectBuilder& descriptorLayout(const DescriptorLayout& layout,
+		                                      uint32_t set = 0) noexcept;
+
+		ShaderObjectBuilder& pushConstantRange(VkShaderStageFlags stages,
+		                                       uint32_t size,
+		                                       uint32_t offset = 0) noexcept;
+
+		template <typename T>
+		    requires std::is_trivially_copyable_v<T>
+		ShaderObjectBuilder& pushConstant(VkShaderStageFlags stages,
+		                                  uint32_t offset = 0) noexcept
+		{
+			static_assert(sizeof(T) % 4 == 0,
+			              "Push constant size must be a multiple of 4");
+			return pushConstantRange(stages, sizeof(T), offset);
+		}
+
+		/**
+		 * \brief Derives the descriptor layouts and push constant range from
+		 * the stages added so far. Sets that already have a layout are kept,
+		 * as are push constant ranges set by hand.
+		 */
+		ShaderObjectBuilder& reflect();
+
+	private:
+		friend class ShaderObject;
+
+		rn<Device> device_;
+		std::vector<VkShaderStageFlagBits> stages_;
+		std::vector<rn<Shader>> shaders_;
+		std::vector<const char*> entrypoints_;
+		std::vector<Specialization> specializations_;
+		std::vector<DescriptorLayout> layouts_;
+		std::vector<VkPushConstantRange> pushConstants_;
+		bool link_ = false;
+	};
+
+	///////////////////////
+	//// Shader Object ////
+	///////////////////////
+
+	/**
+	 * \brief Shader stages created with VK_EXT_shader_object, which are
+	 * bound directly on a command buffer instead of through a pipeline. All
+	 * state is dynamic, so it must be set while recording, including the
+	 * vertex input.
+	 *
+	 * The device needs the extension and its feature enabled.
+	 */
+	class SATURN_API ShaderObject
+	{
+	public:
+		~ShaderObject() noexcept;
+
+		ShaderObject(const ShaderObject&)            = delete;
+		ShaderObject& operator=(const ShaderObject&) = delete;
+
+		std::span<VkShaderStageFlagBits const> stages() const noexcept
+		{
+			return stages_;
+		}
+
+		/**
+		 * \brief Shader of each of \ref stages(), in the same order.
+		 */
+		std::span<VkShaderEXT const> handles() const noexcept
+		{
+			return handles_;
+		}
+
+		/**
+		 * \brief Shared layout, equal for every pipeline and shader object
+		 * built with the same descriptor layouts and push constant ranges.
+		 */
+		VkPipelineLayout layout() const noexcept { return pipelineLayout_; }
+
+		VkDescriptorSetLayout descriptorLayout(uint32_t set = 0) const
+		{
+			return descriptorLayouts_.at(set);
+		}
+
+	private:
+		friend class Builder<ShaderObjectBuilder, ShaderObject>;
+
+		explicit ShaderObject(const ShaderObjectBuilder& builder);
+
+		rn<Device> device_;
+		std::vector<VkShaderStageFlagBits> stages_;
+		std::vector<VkShaderEXT> handles_;
+		std::vector<VkDescriptorSetLayout> descriptorLayouts_;
+		VkPipelineLayout pipelineLayout_;
+	};
+} // namespace sat
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef SATURN_SHADER_WATCHER_HPP
+#define SATURN_SHADER_WATCHER_HPP
+
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "core.hpp"
+#include "pipeline.hpp"
+#include "thread_pool.hpp"
+
+namespace sat
+{
+	class ShaderLoader;
+	class ShaderWatcher;
+
+	/////////////////////////////
+	//// Reloadable Pipeline ////
+	/////////////////////////////
+
+	/**
+	 * \brief Pipeline that a \ref ShaderWatcher rebuilds when the files of
+	 * its shaders change.
+	 */
+	class SATURN_API ReloadablePipeline
+	{
+	public:
+		ReloadablePipeline(const ReloadablePipeline&)            = delete;
+		ReloadablePipeline& operator=(const ReloadablePipeline&) = delete;
+
+		/**
+		 * \brief Current pipeline, which only changes in
+		 * \ref ShaderWatcher::update().
+		 */
+		const rn<Pipeline>& pipeline() const noexcept { return pipeline_; }
+
+		/**
+		 * \brief Why the last rebuild failed, or empty when it succeeded.
+		 * The previous pipeline is kept on failure.
+		 */
+		const std::string& error() const noexcept { return error_; }
+
+	private:
+		friend class ShaderWatcher;
+
+		explicit ReloadablePipeline(PipelineBuilder builder);
+
+		PipelineBuilder builder_;
+		rn<Pipeline> pipeline_;
+		std::string error_;
+
+		// Written by workers under the watcher's lock
+		std::optional<rn<Pipeline>> pending_;
+		std::optional<std::string> pendingError_;
+	};
+
+	////////////////////////
+	//// Shader Watcher ////
+	////////////////////////
+
+	/**
+	 * \brief Watches the files of shaders loaded through a
+	 * \ref ShaderLoader and rebuilds the pipelines using them in the
+	 * background when they change. Watching needs inotify, so it only works
+	 * on Linux.
+	 */
+	class SATURN_API ShaderWatcher
+	{
+	public:
+		/**
+		 * \brief Rebuilds pipelines on a \ref ThreadPool of \p threads
+		 * workers.
+		 */
+		explicit ShaderWatcher(ShaderLoader& loader, unsigned threads = 1);
+		~ShaderWatcher() noexcept;
+
+		ShaderWatcher(const ShaderWatcher&)            = delete;
+		ShaderWatcher& operator=(const ShaderWatcher&) = delete;
+
+		/**
+		 * \brief Builds a pipeline that is rebuilt whenever a shader of
+		 * \p builder loaded from a file changes.
+		 */
+		rn<ReloadablePipeline> watch(PipelineBuilder builder);
+
+		/**
+		 * \brief Swaps in every pipeline rebuilt since the last call. Call
+		 * between frames, as replaced pipelines are destroyed once the
+		 * current frame completes.
+		 *
+		 * \return Number of pipelines swapped.
+		 */
+		size_t update();
+
+		bool supported() const noexcept { return fd_ >= 0; }
+
+	private:
+		void run() noexcept;
+		void reload(const std::set<std::filesystem::path>& paths);
+
+		ShaderLoader& loader_;
+		int fd_ = -1;
+		std::unordered_map<int, std::filesystem::path> directories_;
+		std::vector<rn<ReloadablePipeline>> pipelines_;
+		std::mutex mutex_;
+		std::atomic<bool> stopping_ = false;
+		std::thread thread_;
+
+		// Workers must stop before the pipelines they write to are destroyed
+		ThreadPool pool_;
+	};
+} // namespace sat
+
+#endif
@@ -99,6 +99,11 @@ namespace sat
 		bool acquireNextImage(const rn<Semaphore>& semaphore,
 		                      uint32_t& imageIndex);
 
+		const std::vector<VkImage>& images() const noexcept
+		{
+			return images_;
+		}
+
 		const std::vector<VkImageView>& views() const noexcept
 		{
 			return views_;
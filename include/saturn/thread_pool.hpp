@@ -0,0 +1,114 @@
+#ifndef SATURN_THREAD_POOL_HPP
+#define SATURN_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "core.hpp"
+
+namespace sat
+{
+	/////////////////////
+	//// Thread Pool ////
+	/////////////////////
+
+	class SATURN_API ThreadPool
+	{
+	public:
+		/**
+		 * \brief Starts \p count workers, or one per hardware thread when
+		 * zero.
+		 */
+		explicit ThreadPool(unsigned count = 0);
+		~ThreadPool() noexcept;
+
+		ThreadPool(const ThreadPool&)            = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		/**
+		 * \brief Queues \p task to run on a worker.
+		 *
+		 * \return Future holding the result of the task, or the exception it
+		 * threw.
+		 */
+		template <typename F>
+		std::future<std::invoke_result_t<F>> submit(F&& task);
+
+		/**
+		 * \brief Waits for every future before rethrowing the first
+		 * exception, so no task outlives what it refers to.
+		 *
+		 * \return Results in the order of \p futures.
+		 */
+		template <typename T>
+		static std::vector<T> wait(std::vector<std::future<T>>& futures);
+
+		unsigned size() const noexcept { return threads_.size(); }
+
+	private:
+		void push(std::function<void()> task);
+		void run() noexcept;
+
+		std::vector<std::thread> threads_;
+		std::queue<std::function<void()>> tasks_;
+		std::mutex mutex_;
+		std::condition_variable condition_;
+		bool stopping_ = false;
+	};
+
+	template <typename F>
+	inline std::future<std::invoke_result_t<F>> ThreadPool::submit(F&& task)
+	{
+		using Result = std::invoke_result_t<F>;
+
+		// Packaged tasks are move-only, but queued functions must be copyable
+		auto pTask = std::make_shared<std::packaged_task<Result()>>(
+		    std::forward<F>(task));
+
+		std::future<Result> future = pTask->get_future();
+		push([pTask]() { (*pTask)(); });
+
+		return future;
+	}
+
+	template <typename T>
+	inline std::vector<T> ThreadPool::wait(std::vector<std::future<T>>& futures)
+	{
+		std::vector<T> results;
+		results.reserve(futures.size());
+
+		std::exception_ptr error;
+
+		for (std::future<T>& future : futures)
+		{
+			try
+			{
+				results.push_back(future.get());
+			}
+			catch (...)
+			{
+				if (!error)
+				{
+					error = std::current_exception();
+				}
+			}
+		}
+
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+
+		return results;
+	}
+} // namespace sat
+
+#endif
@@ -0,0 +1,191 @@
+#include "bindless.hpp"
+
+#include <stdexcept>
+
+#include "device.hpp"
+#include "error.hpp"
+#include "layout_cache.hpp"
+
+namespace sat
+{
+	////////////////////////////////
+	//// Bindless Table Builder ////
+	////////////////////////////////
+
+	BindlessTableBuilder::BindlessTableBuilder(rn<Device> device) noexcept
+	    : device_(std::move(device))
+	{}
+
+	BindlessTableBuilder& BindlessTableBuilder::addArray(
+	    VkDescriptorType type,
+	    uint32_t count,
+	    VkShaderStageFlags stages) noexcept
+	{
+		layout_.addBindless(type, stages, count);
+		return *this;
+	}
+
+	////////////////////////
+	//// Bindless Table ////
+	////////////////////////
+
+	BindlessTable::BindlessTable(const BindlessTableBuilder& builder)
+	    : device_(builder.device_), layout_(builder.layout_)
+	{
+		descriptorLayout_ = device_->layoutCache().descriptorLayout(
+		    layout_.bindings(), layout_.flags());
+
+		std::vector<VkDescriptorPoolSize> sizes;
+
+		for (const VkDescriptorSetLayoutBinding& binding : layout_.bindings())
+		{
+			sizes.push_back({binding.descriptorType, binding.descriptorCount});
+
+			Array array;
+			array.type  = binding.descriptorType;
+			array.count = binding.descriptorCount;
+			array.live.resize(binding.descriptorCount);
+			arrays_.push_back(std::move(array));
+		}
+
+		VkDescriptorPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+		poolInfo.maxSets       = 1;
+		poolInfo.poolSizeCount = sizes.size();
+		poolInfo.pPoolSizes    = sizes.data();
+
+		SATURN_CALL(
+		    vkCreateDescriptorPool(device_, &poolInfo, nullptr, &pool_));
+
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool     = pool_;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts        = &descriptorLayout_;
+
+		try
+		{
+			SATURN_CALL(
+			    vkAllocateDescriptorSets(device_, &allocInfo, &handle_));
+		}
+		catch (...)
+		{
+			vkDestroyDescriptorPool(device_, pool_, nullptr);
+			throw;
+		}
+	}
+
+	BindlessTable::~BindlessTable() noexcept
+	{
+		device_->destroy([device = device_->handle(), pool = pool_]() {
+			vkDestroyDescriptorPool(device, pool, nullptr);
+		});
+	}
+
+	uint32_t BindlessTable::add(uint32_t binding,
+	                            VkBuffer buffer,
+	                            VkDeviceSize offset,
+	                            VkDeviceSize range)
+	{
+		VkDescriptorBufferInfo info{};
+		info.buffer = buffer;
+		info.offset = offset;
+		info.range  = range;
+
+		std::lock_guard lock(mutex_);
+
+		uint32_t slot = acquire(binding);
+		write(binding, slot, &info, nullptr);
+
+		return slot;
+	}
+
+	uint32_t BindlessTable::add(uint32_t binding,
+	                            VkImageView view,
+	                            VkImageLayout layout,
+	                            VkSampler sampler)
+	{
+		VkDescriptorImageInfo info{};
+		info.sampler     = sampler;
+		info.imageView   = view;
+		info.imageLayout = layout;
+
+		std::lock_guard lock(mutex_);
+
+		uint32_t slot = acquire(binding);
+		write(binding, slot, nullptr, &info);
+
+		return slot;
+	}
+
+	void BindlessTable::remove(uint32_t binding, uint32_t slot)
+	{
+		std::lock_guard lock(mutex_);
+
+		Array& array = arrays_.at(binding);
+
+		if (slot >= array.count || !array.live[slot])
+		{
+			throw std::invalid_argument("Bindless slot isn't in use");
+		}
+
+		array.live[slot] = false;
+		array.retired.push_back({device_->frame(), slot});
+	}
+
+	uint32_t BindlessTable::acquire(uint32_t binding)
+	{
+		Array& array = arrays_.at(binding);
+
+		// Shaders of frames still in flight may read retired slots
+		if (!array.retired.empty())
+		{
+			uint64_t completed = device_->completed();
+
+			while (!array.retired.empty() &&
+			       array.retired.front().frame <= completed)
+			{
+				array.free.push_back(array.retired.front().slot);
+				array.retired.pop_front();
+			}
+		}
+
+		uint32_t slot;
+
+		if (!array.free.empty())
+		{
+			slot = array.free.back();
+			array.free.pop_back();
+		}
+		else if (array.next < array.count)
+		{
+			slot = array.next++;
+		}
+		else
+		{
+			throw std::runtime_error("Bindless table is full");
+		}
+
+		array.live[slot] = true;
+		return slot;
+	}
+
+	void BindlessTable::write(uint32_t binding,
+	                          uint32_t slot,
+	                          const VkDescriptorBufferInfo* pBufferInfo,
+	                          const VkDescriptorImageInfo* pImageInfo)
+	{
+		VkWriteDescriptorSet write{};
+		write.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet          = handle_;
+		write.dstBinding      = binding;
+		write.dstArrayElement = slot;
+		write.descriptorCount = 1;
+		write.descriptorType  = arrays_[binding].type;
+		write.pBufferInfo     = pBufferInfo;
+		write.pImageInfo      = pImageInfo;
+
+		vkUpdateDescriptorSets(device_, 1, &write, 0, nullptr);
+	}
+} // namespace sat
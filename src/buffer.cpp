@@ -208,6 +208,12 @@ namespace sat
 
 	Buffer::~Buffer() noexcept
 	{
-		vmaDestroyBuffer(device_->allocator(), handle_, allocation_);
+		device_->invalidateBuffer(handle_);
+
+		device_->destroy([allocator  = device_->allocator(),
+		                  handle     = handle_,
+		                  allocation = allocation_]() {
+			vmaDestroyBuffer(allocator, handle, allocation);
+		});
 	}
 } // namespace sat
@@ -1,9 +1,12 @@
 #include "command.hpp"
 
+#include <vector>
+
 #include "device.hpp"
 #include "error.hpp"
 #include "pipeline.hpp"
 #include "render_pass.hpp"
+#include "shader_object.hpp"
 
 namespace sat
 {
@@ -64,7 +67,7 @@ namespace sat
 		VkCommandBuffer handle;
 		SATURN_CALL(vkAllocateCommandBuffers(device_, &allocInfo, &handle));
 
-		return CommandBuffer(handle);
+		return CommandBuffer(handle, &device_->dispatch());
 	}
 
 	void CommandPool::free(CommandBuffer& buffer) const noexcept
@@ -80,18 +83,24 @@ namespace sat
 	//// Command Buffer ////
 	////////////////////////
 
-	CommandBuffer::CommandBuffer(VkCommandBuffer handle)
+	CommandBuffer::CommandBuffer(VkCommandBuffer handle,
+	                             const DeviceDispatch* pDispatch)
+	    : dispatch_(pDispatch)
 	{
 		handle_ = handle;
 	}
 
 	CommandBuffer::CommandBuffer(CommandBuffer&& other) noexcept
-	    : Container(other.handle_)
+	    : Container(other.handle_),
+	      dispatch_(other.dispatch_),
+	      layout_(other.layout_)
 	{}
 
 	CommandBuffer& CommandBuffer::operator=(CommandBuffer&& other) noexcept
 	{
-		handle_ = other.handle_;
+		handle_   = other.handle_;
+		dispatch_ = other.dispatch_;
+		layout_   = other.layout_;
 
 		other.handle_ = VK_NULL_HANDLE;
 
@@ -145,6 +154,70 @@ namespace sat
 		vkCmdEndRenderPass(handle_);
 	}
 
+	void CommandBuffer::beginRendering(
+	    const VkExtent2D& extent,
+	    std::span<RenderingAttachment const> colorAttachments,
+	    const RenderingAttachment* pDepthAttachment,
+	    const RenderingAttachment* pStencilAttachment,
+	    const VkOffset2D& offset)
+	{
+		auto convert = [](const RenderingAttachment& attachment) {
+			VkRenderingAttachmentInfoKHR info{};
+			info.sType       = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+			info.imageView   = attachment.view;
+			info.imageLayout = attachment.layout;
+			info.loadOp      = attachment.loadOp;
+			info.storeOp     = attachment.storeOp;
+			info.clearValue  = attachment.clearValue;
+			return info;
+		};
+
+		std::vector<VkRenderingAttachmentInfoKHR> colors;
+		colors.reserve(colorAttachments.size());
+
+		for (const RenderingAttachment& attachment : colorAttachments)
+		{
+			colors.push_back(convert(attachment));
+		}
+
+		VkRenderingInfoKHR renderingInfo{};
+		renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+		renderingInfo.renderArea.offset    = offset;
+		renderingInfo.renderArea.extent    = extent;
+		renderingInfo.layerCount           = 1;
+		renderingInfo.colorAttachmentCount = colors.size();
+		renderingInfo.pColorAttachments    = colors.data();
+
+		VkRenderingAttachmentInfoKHR depth{};
+		VkRenderingAttachmentInfoKHR stencil{};
+
+		if (pDepthAttachment)
+		{
+			depth                          = convert(*pDepthAttachment);
+			renderingInfo.pDepthAttachment = &depth;
+		}
+
+		if (pStencilAttachment)
+		{
+			stencil                          = convert(*pStencilAttachment);
+			renderingInfo.pStencilAttachment = &stencil;
+		}
+
+		dispatch_->vkCmdBeginRenderingKHR(handle_, &renderingInfo);
+	}
+
+	void CommandBuffer::beginRendering(
+	    const VkExtent2D& extent,
+	    const RenderingAttachment& colorAttachment)
+	{
+		beginRendering(extent, {&colorAttachment, 1});
+	}
+
+	void CommandBuffer::endRendering() noexcept
+	{
+		dispatch_->vkCmdEndRenderingKHR(handle_);
+	}
+
 	void CommandBuffer::viewport(const VkExtent2D& extent,
 	                             const VkOffset2D& offset,
 	                             float min,
@@ -181,9 +254,231 @@ namespace sat
 		vkCmdSetScissor(handle_, 0, 1, &scissor);
 	}
 
-	void CommandBuffer::bindPipeline(VkPipeline pipeline) noexcept
+	////////////////////////////////
+	//// Extended Dynamic State ////
+	////////////////////////////////
+
+	void CommandBuffer::cullMode(VkCullModeFlags cullMode) noexcept
+	{
+		dispatch_->vkCmdSetCullModeEXT(handle_, cullMode);
+	}
+
+	void CommandBuffer::frontFace(VkFrontFace frontFace) noexcept
+	{
+		dispatch_->vkCmdSetFrontFaceEXT(handle_, frontFace);
+	}
+
+	void CommandBuffer::topology(VkPrimitiveTopology topology) noexcept
+	{
+		dispatch_->vkCmdSetPrimitiveTopologyEXT(handle_, topology);
+	}
+
+	void CommandBuffer::viewports(
+	    std::span<VkViewport const> viewports) noexcept
+	{
+		dispatch_->vkCmdSetViewportWithCountEXT(
+		    handle_, viewports.size(), viewports.data());
+	}
+
+	void CommandBuffer::scissors(std::span<VkRect2D const> scissors) noexcept
+	{
+		dispatch_->vkCmdSetScissorWithCountEXT(
+		    handle_, scissors.size(), scissors.data());
+	}
+
+	void CommandBuffer::depthTest(bool enable) noexcept
+	{
+		dispatch_->vkCmdSetDepthTestEnableEXT(handle_, enable);
+	}
+
+	void CommandBuffer::depthWrite(bool enable) noexcept
+	{
+		dispatch_->vkCmdSetDepthWriteEnableEXT(handle_, enable);
+	}
+
+	void CommandBuffer::depthCompareOp(VkCompareOp compareOp) noexcept
+	{
+		dispatch_->vkCmdSetDepthCompareOpEXT(handle_, compareOp);
+	}
+
+	void CommandBuffer::depthBoundsTest(bool enable) noexcept
+	{
+		dispatch_->vkCmdSetDepthBoundsTestEnableEXT(handle_, enable);
+	}
+
+	void CommandBuffer::stencilTest(bool enable) noexcept
+	{
+		dispatch_->vkCmdSetStencilTestEnableEXT(handle_, enable);
+	}
+
+	void CommandBuffer::stencilOp(VkStencilFaceFlags faces,
+	                              VkStencilOp failOp,
+	                              VkStencilOp passOp,
+	                              VkStencilOp depthFailOp,
+	                              VkCompareOp compareOp) noexcept
+	{
+		dispatch_->vkCmdSetStencilOpEXT(
+		    handle_, faces, failOp, passOp, depthFailOp, compareOp);
+	}
+
+	void CommandBuffer::rasterizerDiscard(bool enable) noexcept
+	{
+		dispatch_->vkCmdSetRasterizerDiscardEnableEXT(handle_, enable);
+	}
+
+	void CommandBuffer::depthBias(bool enable) noexcept
+	{
+		dispatch_->vkCmdSetDepthBiasEnableEXT(handle_, enable);
+	}
+
+	void CommandBuffer::primitiveRestart(bool enable) noexcept
+	{
+		dispatch_->vkCmdSetPrimitiveRestartEnableEXT(handle_, enable);
+	}
+
+	void CommandBuffer::polygonMode(VkPolygonMode polygonMode) noexcept
 	{
-		vkCmdBindPipeline(handle_, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+		dispatch_->vkCmdSetPolygonModeEXT(handle_, polygonMode);
+	}
+
+	void CommandBuffer::rasterizationSamples(
+	    VkSampleCountFlagBits samples) noexcept
+	{
+		dispatch_->vkCmdSetRasterizationSamplesEXT(handle_, samples);
+	}
+
+	void CommandBuffer::alphaToCoverage(bool enable) noexcept
+	{
+		dispatch_->vkCmdSetAlphaToCoverageEnableEXT(handle_, enable);
+	}
+
+	void CommandBuffer::depthClamp(bool enable) noexcept
+	{
+		dispatch_->vkCmdSetDepthClampEnableEXT(handle_, enable);
+	}
+
+	void CommandBuffer::logicOp(bool enable) noexcept
+	{
+		dispatch_->vkCmdSetLogicOpEnableEXT(handle_, enable);
+	}
+
+	void CommandBuffer::colorBlend(uint32_t first,
+	                               std::span<VkBool32 const> enables) noexcept
+	{
+		dispatch_->vkCmdSetColorBlendEnableEXT(
+		    handle_, first, enables.size(), enables.data());
+	}
+
+	void CommandBuffer::colorBlendEquation(
+	    uint32_t first,
+	    std::span<VkColorBlendEquationEXT const> equations) noexcept
+	{
+		dispatch_->vkCmdSetColorBlendEquationEXT(
+		    handle_, first, equations.size(), equations.data());
+	}
+
+	void CommandBuffer::colorWriteMask(
+	    uint32_t first,
+	    std::span<VkColorComponentFlags const> masks) noexcept
+	{
+		dispatch_->vkCmdSetColorWriteMaskEXT(
+		    handle_, first, masks.size(), masks.data());
+	}
+
+	void CommandBuffer::sampleMask(VkSampleCountFlagBits samples,
+	                               VkSampleMask mask) noexcept
+	{
+		dispatch_->vkCmdSetSampleMaskEXT(handle_, samples, &mask);
+	}
+
+	void CommandBuffer::vertexInput(const VertexDescription& description)
+	{
+		std::vector<VkVertexInputBindingDescription2EXT> bindings;
+		for (const VkVertexInputBindingDescription& binding :
+		     description.bindings())
+		{
+			VkVertexInputBindingDescription2EXT& converted =
+			    bindings.emplace_back();
+			converted.sType =
+			    VK_STRUCTURE_TYPE_VERTEX_INPUT_BINDING_DESCRIPTION_2_EXT;
+			converted.binding   = binding.binding;
+			converted.stride    = binding.stride;
+			converted.inputRate = binding.inputRate;
+			converted.divisor   = 1;
+		}
+
+		std::vector<VkVertexInputAttributeDescription2EXT> attributes;
+		for (const VkVertexInputAttributeDescription& attribute :
+		     description.attributes())
+		{
+			VkVertexInputAttributeDescription2EXT& converted =
+			    attributes.emplace_back();
+			converted.sType =
+			    VK_STRUCTURE_TYPE_VERTEX_INPUT_ATTRIBUTE_DESCRIPTION_2_EXT;
+			converted.location = attribute.location;
+			converted.binding  = attribute.binding;
+			converted.format   = attribute.format;
+			converted.offset   = attribute.offset;
+		}
+
+		dispatch_->vkCmdSetVertexInputEXT(handle_,
+		                                  bindings.size(),
+		                                  bindings.data(),
+		                                  attributes.size(),
+		                                  attributes.data());
+	}
+
+	void CommandBuffer::bindPipeline(VkPipeline pipeline,
+	                                 VkPipelineBindPoint bindPoint) noexcept
+	{
+		vkCmdBindPipeline(handle_, bindPoint, pipeline);
+		layout_ = VK_NULL_HANDLE;
+	}
+
+	void CommandBuffer::bindPipeline(const rn<Pipeline>& pipeline) noexcept
+	{
+		vkCmdBindPipeline(handle_, pipeline->bindPoint(), pipeline->handle());
+		layout_ = pipeline->layout();
+	}
+
+	void CommandBuffer::bindShader(VkShaderStageFlagBits stage,
+	                               VkShaderEXT shader) noexcept
+	{
+		dispatch_->vkCmdBindShadersEXT(handle_, 1, &stage, &shader);
+	}
+
+	void CommandBuffer::bindShaders(const rn<ShaderObject>& shaders) noexcept
+	{
+		dispatch_->vkCmdBindShadersEXT(handle_,
+		                               shaders->stages().size(),
+		                               shaders->stages().data(),
+		                               shaders->handles().data());
+		layout_ = shaders->layout();
+	}
+
+	void CommandBuffer::pushConstants(VkPipelineLayout layout,
+	                                  VkShaderStageFlags stages,
+	                                  uint32_t offset,
+	                                  uint32_t size,
+	                                  const void* pValues) noexcept
+	{
+		vkCmdPushConstants(handle_, layout, stages, offset, size, pValues);
+	}
+
+	void CommandBuffer::bindDescriptorSets(
+	    VkPipelineLayout layout,
+	    std::span<VkDescriptorSet const> sets,
+	    uint32_t first,
+	    VkPipelineBindPoint bindPoint) noexcept
+	{
+		vkCmdBindDescriptorSets(handle_,
+		                        bindPoint,
+		                        layout,
+		                        first,
+		                        sets.size(),
+		                        sets.data(),
+		                        0,
+		                        nullptr);
 	}
 
 	void CommandBuffer::bindVertexBuffer(VkBuffer buffer,
@@ -209,6 +504,81 @@ namespace sat
 		vkCmdDrawIndexed(handle_, count, 1, index, 0, 0);
 	}
 
+	void CommandBuffer::dispatch(uint32_t x, uint32_t y, uint32_t z) noexcept
+	{
+		vkCmdDispatch(handle_, x, y, z);
+	}
+
+	void CommandBuffer::dispatchIndirect(VkBuffer buffer,
+	                                     VkDeviceSize offset) noexcept
+	{
+		vkCmdDispatchIndirect(handle_, buffer, offset);
+	}
+
+	void CommandBuffer::barrier(VkBuffer buffer,
+	                            VkPipelineStageFlags srcStage,
+	                            VkAccessFlags srcAccess,
+	                            VkPipelineStageFlags dstStage,
+	                            VkAccessFlags dstAccess,
+	                            VkDeviceSize offset,
+	                            VkDeviceSize size) noexcept
+	{
+		VkBufferMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcAccessMask       = srcAccess;
+		barrier.dstAccessMask       = dstAccess;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.buffer              = buffer;
+		barrier.offset              = offset;
+		barrier.size                = size;
+
+		vkCmdPipelineBarrier(handle_,
+		                     srcStage,
+		                     dstStage,
+		                     0,
+		                     0,
+		                     nullptr,
+		                     1,
+		                     &barrier,
+		                     0,
+		                     nullptr);
+	}
+
+	void CommandBuffer::transition(VkImage image,
+	                               VkImageLayout oldLayout,
+	                               VkImageLayout newLayout,
+	                               VkPipelineStageFlags srcStage,
+	                               VkAccessFlags srcAccess,
+	                               VkPipelineStageFlags dstStage,
+	                               VkAccessFlags dstAccess,
+	                               VkImageAspectFlags aspect) noexcept
+	{
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcAccessMask               = srcAccess;
+		barrier.dstAccessMask               = dstAccess;
+		barrier.oldLayout                   = oldLayout;
+		barrier.newLayout                   = newLayout;
+		barrier.srcQueueFamilyIndex         = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex         = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image                       = image;
+		barrier.subresourceRange.aspectMask = aspect;
+		barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+		barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+
+		vkCmdPipelineBarrier(handle_,
+		                     srcStage,
+		                     dstStage,
+		                     0,
+		                     0,
+		                     nullptr,
+		                     0,
+		                     nullptr,
+		                     1,
+		                     &barrier);
+	}
+
 	void CommandBuffer::copy(VkBuffer dst,
 	                         VkBuffer src,
 	                         VkDeviceSize size,
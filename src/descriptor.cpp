@@ -0,0 +1,518 @@
+#include "descriptor.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "device.hpp"
+#include "error.hpp"
+#include "key.hpp"
+
+namespace sat
+{
+	//////////////////////////////////////
+	//// Descriptor Allocator Builder ////
+	//////////////////////////////////////
+
+	DescriptorAllocatorBuilder::DescriptorAllocatorBuilder(
+	    rn<Device> device) noexcept
+	    : device_(std::move(device))
+	{}
+
+	DescriptorAllocatorBuilder& DescriptorAllocatorBuilder::maxSets(
+	    uint32_t count) noexcept
+	{
+		maxSets_ = count;
+		return *this;
+	}
+
+	DescriptorAllocatorBuilder& DescriptorAllocatorBuilder::addPoolSize(
+	    VkDescriptorType type,
+	    float perSet) noexcept
+	{
+		sizes_.emplace_back(type, perSet);
+		return *this;
+	}
+
+	DescriptorAllocatorBuilder& DescriptorAllocatorBuilder::flags(
+	    VkDescriptorPoolCreateFlags flags) noexcept
+	{
+		flags_ = flags;
+		return *this;
+	}
+
+	DescriptorAllocatorBuilder& DescriptorAllocatorBuilder::perFrame(
+	    unsigned count) noexcept
+	{
+		frames_ = count;
+		return *this;
+	}
+
+	//////////////////////////////
+	//// Descriptor Allocator ////
+	//////////////////////////////
+
+	DescriptorAllocator::DescriptorAllocator(
+	    const DescriptorAllocatorBuilder& builder)
+	    : device_(builder.device_),
+	      maxSets_(std::max(builder.maxSets_, 1u)),
+	      sizes_(builder.sizes_),
+	      flags_(builder.flags_),
+	      perFrame_(builder.frames_ > 0),
+	      chains_(std::max(builder.frames_, 1u))
+	{
+		if (sizes_.empty())
+		{
+			sizes_ = {
+			    {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2},
+			    {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2},
+			    {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1},
+			    {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1},
+			    {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4},
+			    {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 2},
+			    {VK_DESCRIPTOR_TYPE_SAMPLER, 1},
+			    {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1},
+			    {VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1},
+			};
+		}
+	}
+
+	DescriptorAllocator::~DescriptorAllocator() noexcept
+	{
+		for (Chain& chain : chains_)
+		{
+			device_->destroy([device = device_->handle(),
+			                  pools  = std::move(chain.pools)]() {
+				for (VkDescriptorPool pool : pools)
+				{
+					vkDestroyDescriptorPool(device, pool, nullptr);
+				}
+			});
+		}
+	}
+
+	VkDescriptorSet DescriptorAllocator::allocate(VkDescriptorSetLayout layout)
+	{
+		return allocate(std::span(&layout, 1)).front();
+	}
+
+	std::vector<VkDescriptorSet> DescriptorAllocator::allocate(
+	    std::span<VkDescriptorSetLayout const> layouts)
+	{
+		std::vector<VkDescriptorSet> sets(layouts.size());
+
+		if (layouts.empty())
+		{
+			return sets;
+		}
+
+		std::lock_guard lock(mutex_);
+
+		Chain& chain = this->chain();
+
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorSetCount = layouts.size();
+		allocInfo.pSetLayouts        = layouts.data();
+
+		// A pool that can't fit the batch is full; move on to the next
+		for (;; ++chain.current)
+		{
+			bool created = chain.current == chain.pools.size();
+
+			if (created)
+			{
+				uint32_t maxSets = maxSets_ << std::min<size_t>(
+				                       chain.pools.size(), 6);
+				maxSets = std::max<uint32_t>(maxSets, layouts.size());
+
+				chain.pools.push_back(createPool(maxSets));
+			}
+
+			allocInfo.descriptorPool = chain.pools[chain.current];
+
+			VkResult result =
+			    vkAllocateDescriptorSets(device_, &allocInfo, sets.data());
+
+			if (result == VK_SUCCESS)
+			{
+				return sets;
+			}
+
+			// An empty pool that can't fit the batch never will, as the
+			// layouts need types or counts the pool sizes don't cover
+			if (created || (result != VK_ERROR_OUT_OF_POOL_MEMORY &&
+			                result != VK_ERROR_FRAGMENTED_POOL))
+			{
+				SATURN_CALL(result);
+			}
+		}
+	}
+
+	void DescriptorAllocator::reset()
+	{
+		std::lock_guard lock(mutex_);
+
+		for (Chain& chain : chains_)
+		{
+			reset(chain);
+		}
+	}
+
+	DescriptorAllocator::Chain& DescriptorAllocator::chain()
+	{
+		if (!perFrame_)
+		{
+			return chains_.front();
+		}
+
+		uint64_t frame = device_->frame();
+		Chain& chain   = chains_[frame % chains_.size()];
+
+		if (chain.frame != frame)
+		{
+			// The sets of the chain's last frame may still be in use
+			if (chain.frame > device_->completed())
+			{
+				device_->wait(chain.frame);
+			}
+
+			reset(chain);
+			chain.frame = frame;
+		}
+
+		return chain;
+	}
+
+	void DescriptorAllocator::reset(Chain& chain)
+	{
+		for (VkDescriptorPool pool : chain.pools)
+		{
+			SATURN_CALL(vkResetDescriptorPool(device_, pool, 0));
+		}
+
+		chain.current = 0;
+	}
+
+	VkDescriptorPool DescriptorAllocator::createPool(uint32_t maxSets) const
+	{
+		std::vector<VkDescriptorPoolSize> sizes;
+
+		for (const auto& [type, perSet] : sizes_)
+		{
+			sizes.push_back(
+			    {type, static_cast<uint32_t>(std::ceil(perSet * maxSets))});
+		}
+
+		VkDescriptorPoolCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		createInfo.flags = flags_;
+		createInfo.maxSets       = maxSets;
+		createInfo.poolSizeCount = sizes.size();
+		createInfo.pPoolSizes    = sizes.data();
+
+		VkDescriptorPool pool;
+		SATURN_CALL(
+		    vkCreateDescriptorPool(device_, &createInfo, nullptr, &pool));
+
+		return pool;
+	}
+
+	///////////////////////////
+	//// Descriptor Writer ////
+	///////////////////////////
+
+	DescriptorWriter& DescriptorWriter::buffer(VkDescriptorSet set,
+	                                           uint32_t binding,
+	                                           VkDescriptorType type,
+	                                           VkBuffer buffer,
+	                                           VkDeviceSize offset,
+	                                           VkDeviceSize range,
+	                                           uint32_t element)
+	{
+		VkDescriptorBufferInfo info{};
+		info.buffer = buffer;
+		info.offset = offset;
+		info.range  = range;
+
+		VkWriteDescriptorSet write{};
+		write.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet          = set;
+		write.dstBinding      = binding;
+		write.dstArrayElement = element;
+		write.descriptorCount = 1;
+		write.descriptorType  = type;
+		write.pBufferInfo     = &buffers_.emplace_back(info);
+
+		writes_.push_back(write);
+
+		return *this;
+	}
+
+	DescriptorWriter& DescriptorWriter::image(VkDescriptorSet set,
+	                                          uint32_t binding,
+	                                          VkDescriptorType type,
+	                                          VkImageView view,
+	                                          VkImageLayout layout,
+	                                          VkSampler sampler,
+	                                          uint32_t element)
+	{
+		VkDescriptorImageInfo info{};
+		info.sampler     = sampler;
+		info.imageView   = view;
+		info.imageLayout = layout;
+
+		VkWriteDescriptorSet write{};
+		write.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet          = set;
+		write.dstBinding      = binding;
+		write.dstArrayElement = element;
+		write.descriptorCount = 1;
+		write.descriptorType  = type;
+		write.pImageInfo      = &images_.emplace_back(info);
+
+		writes_.push_back(write);
+
+		return *this;
+	}
+
+	void DescriptorWriter::update(VkDevice device)
+	{
+		vkUpdateDescriptorSets(
+		    device, writes_.size(), writes_.data(), 0, nullptr);
+
+		writes_.clear();
+		buffers_.clear();
+		images_.clear();
+	}
+
+	/////////////////////////////
+	//// Descriptor Bindings ////
+	/////////////////////////////
+
+	DescriptorBindings& DescriptorBindings::buffer(uint32_t binding,
+	                                               VkDescriptorType type,
+	                                               VkBuffer buffer,
+	                                               VkDeviceSize offset,
+	                                               VkDeviceSize range,
+	                                               uint32_t element)
+	{
+		Entry entry{};
+		entry.binding       = binding;
+		entry.element       = element;
+		entry.type          = type;
+		entry.buffer.buffer = buffer;
+		entry.buffer.offset = offset;
+		entry.buffer.range  = range;
+
+		entries_.push_back(entry);
+		return *this;
+	}
+
+	DescriptorBindings& DescriptorBindings::image(uint32_t binding,
+	                                              VkDescriptorType type,
+	                                              VkImageView view,
+	                                              VkImageLayout layout,
+	                                              VkSampler sampler,
+	                                              uint32_t element)
+	{
+		Entry entry{};
+		entry.binding           = binding;
+		entry.element           = element;
+		entry.type              = type;
+		entry.image.sampler     = sampler;
+		entry.image.imageView   = view;
+		entry.image.imageLayout = layout;
+		entry.isImage           = true;
+
+		entries_.push_back(entry);
+		return *this;
+	}
+
+	void DescriptorBindings::write(DescriptorWriter& writer,
+	                               VkDescriptorSet set) const
+	{
+		for (const Entry& entry : entries_)
+		{
+			if (entry.isImage)
+			{
+				writer.image(set,
+				             entry.binding,
+				             entry.type,
+				             entry.image.imageView,
+				             entry.image.imageLayout,
+				             entry.image.sampler,
+				             entry.element);
+			}
+			else
+			{
+				writer.buffer(set,
+				              entry.binding,
+				              entry.type,
+				              entry.buffer.buffer,
+				              entry.buffer.offset,
+				              entry.buffer.range,
+				              entry.element);
+			}
+		}
+	}
+
+	//////////////////////////////
+	//// Descriptor Set Cache ////
+	//////////////////////////////
+
+	DescriptorSetCache::DescriptorSetCache(rn<Device> device, uint64_t maxAge)
+	    : device_(device),
+	      maxAge_(maxAge),
+	      allocator_(DescriptorAllocatorBuilder(std::move(device)).build())
+	{
+		std::lock_guard lock(device_->setCacheMutex_);
+		device_->setCaches_.push_back(this);
+	}
+
+	DescriptorSetCache::~DescriptorSetCache() noexcept
+	{
+		std::lock_guard lock(device_->setCacheMutex_);
+		std::erase(device_->setCaches_, this);
+	}
+
+	template <typename F>
+	void DescriptorSetCache::drop(F&& predicate)
+	{
+		std::lock_guard lock(mutex_);
+
+		for (auto it = entries_.begin(); it != entries_.end();)
+		{
+			if (!predicate(*it))
+			{
+				++it;
+				continue;
+			}
+
+			sets_.erase(it->key);
+			retired_.push_back(std::move(*it));
+			it = entries_.erase(it);
+		}
+	}
+
+	VkDescriptorSet DescriptorSetCache::get(VkDescriptorSetLayout layout,
+	                                        const DescriptorBindings& bindings)
+	{
+		Key key;
+		key << layout << static_cast<uint32_t>(bindings.entries_.size());
+
+		std::vector<VkImageView> views;
+		std::vector<VkBuffer> buffers;
+
+		for (const DescriptorBindings::Entry& entry : bindings.entries_)
+		{
+			key << entry.binding << entry.element << entry.type;
+
+			if (entry.isImage)
+			{
+				key << entry.image.sampler << entry.image.imageView
+				    << entry.image.imageLayout;
+				views.push_back(entry.image.imageView);
+			}
+			else
+			{
+				key << entry.buffer.buffer << entry.buffer.offset
+				    << entry.buffer.range;
+				buffers.push_back(entry.buffer.buffer);
+			}
+		}
+
+		uint64_t frame = device_->frame();
+
+		std::lock_guard lock(mutex_);
+
+		auto it = sets_.find(key.str());
+		if (it != sets_.end())
+		{
+			it->second->frame = frame;
+			entries_.splice(entries_.end(), entries_, it->second);
+
+			return it->second->set;
+		}
+
+		VkDescriptorSet set;
+		std::vector<VkDescriptorSet>& free = free_[layout];
+
+		if (!free.empty())
+		{
+			set = free.back();
+			free.pop_back();
+		}
+		else
+		{
+			set = allocator_->allocate(layout);
+		}
+
+		DescriptorWriter writer;
+		bindings.write(writer, set);
+		writer.update(device_);
+
+		entries_.push_back({std::move(key).str(),
+		                    layout,
+		                    set,
+		                    frame,
+		                    std::move(views),
+		                    std::move(buffers)});
+		sets_.emplace(entries_.back().key, std::prev(entries_.end()));
+
+		return set;
+	}
+
+	void DescriptorSetCache::collect()
+	{
+		uint64_t frame     = device_->frame();
+		uint64_t completed = device_->completed();
+
+		std::lock_guard lock(mutex_);
+
+		std::erase_if(retired_, [&](const Entry& entry) {
+			if (entry.frame > completed)
+			{
+				return false;
+			}
+
+			free_[entry.layout].push_back(entry.set);
+			return true;
+		});
+
+		// Entries are ordered by age, so stop at the first one still fresh
+		while (!entries_.empty())
+		{
+			const Entry& entry = entries_.front();
+
+			if (entry.frame + maxAge_ >= frame || entry.frame > completed)
+			{
+				break;
+			}
+
+			free_[entry.layout].push_back(entry.set);
+			sets_.erase(entry.key);
+			entries_.pop_front();
+		}
+	}
+
+	void DescriptorSetCache::invalidateView(VkImageView view)
+	{
+		drop([view](const Entry& entry) {
+			return std::ranges::find(entry.views, view) != entry.views.end();
+		});
+	}
+
+	void DescriptorSetCache::invalidateBuffer(VkBuffer buffer)
+	{
+		drop([buffer](const Entry& entry) {
+			return std::ranges::find(entry.buffers, buffer) !=
+			       entry.buffers.end();
+		});
+	}
+
+	size_t DescriptorSetCache::size() const
+	{
+		std::lock_guard lock(mutex_);
+		return entries_.size();
+	}
+} // namespace sat
@@ -0,0 +1,112 @@
+#include "descriptor_template.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+#include "device.hpp"
+#include "error.hpp"
+#include "layout_cache.hpp"
+
+namespace sat
+{
+	namespace
+	{
+		/**
+		 * \brief Size of the info \p type is written from, or zero when
+		 * templates don't support it.
+		 */
+		size_t descriptor_size(VkDescriptorType type) noexcept
+		{
+			switch (type)
+			{
+			case VK_DESCRIPTOR_TYPE_SAMPLER:
+			case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+			case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+			case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+			case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+				return sizeof(VkDescriptorImageInfo);
+			case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+			case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+			case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+			case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+				return sizeof(VkDescriptorBufferInfo);
+			case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+			case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+				return sizeof(VkBufferView);
+			default:
+				return 0;
+			}
+		}
+	} // namespace
+
+	/////////////////////////////////////
+	//// Descriptor Template Builder ////
+	/////////////////////////////////////
+
+	DescriptorTemplateBuilder::DescriptorTemplateBuilder(
+	    rn<Device> device,
+	    const DescriptorLayout& layout) noexcept
+	    : device_(std::move(device)), layout_(layout)
+	{}
+
+	/////////////////////////////
+	//// Descriptor Template ////
+	/////////////////////////////
+
+	DescriptorTemplate::DescriptorTemplate(
+	    const DescriptorTemplateBuilder& builder)
+	    : device_(builder.device_)
+	{
+		descriptorLayout_ = device_->layoutCache().descriptorLayout(
+		    builder.layout_.bindings(), builder.layout_.flags());
+
+		std::vector<VkDescriptorUpdateTemplateEntry> entries;
+
+		for (const VkDescriptorSetLayoutBinding& binding :
+		     builder.layout_.bindings())
+		{
+			size_t stride = descriptor_size(binding.descriptorType);
+
+			if (stride == 0)
+			{
+				throw std::invalid_argument(
+				    "Descriptor type isn't supported by templates");
+			}
+
+			VkDescriptorUpdateTemplateEntry entry{};
+			entry.dstBinding      = binding.binding;
+			entry.descriptorCount = binding.descriptorCount;
+			entry.descriptorType  = binding.descriptorType;
+			entry.offset          = size_;
+			entry.stride          = stride;
+
+			entries.push_back(entry);
+			size_ += stride * binding.descriptorCount;
+		}
+
+		VkDescriptorUpdateTemplateCreateInfo createInfo{};
+		createInfo.sType =
+		    VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+		createInfo.descriptorUpdateEntryCount = entries.size();
+		createInfo.pDescriptorUpdateEntries   = entries.data();
+		createInfo.templateType =
+		    VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+		createInfo.descriptorSetLayout = descriptorLayout_;
+
+		SATURN_CALL(vkCreateDescriptorUpdateTemplate(
+		    device_, &createInfo, nullptr, &handle_));
+	}
+
+	DescriptorTemplate::~DescriptorTemplate() noexcept
+	{
+		device_->destroy([device = device_->handle(), handle = handle_]() {
+			vkDestroyDescriptorUpdateTemplate(device, handle, nullptr);
+		});
+	}
+
+	void DescriptorTemplate::update(VkDescriptorSet set,
+	                                const void* pData) const noexcept
+	{
+		vkUpdateDescriptorSetWithTemplate(device_, set, handle_, pData);
+	}
+} // namespace sat
@@ -1,10 +1,17 @@
 #include "device.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <ranges>
+#include <stdexcept>
 
+#include "descriptor.hpp"
 #include "error.hpp"
+#include "framebuffer_cache.hpp"
 #include "instance.hpp"
+#include "layout_cache.hpp"
+#include "pipeline_cache.hpp"
+#include "pipeline_stats.hpp"
 
 namespace sat
 {
@@ -31,12 +38,27 @@ namespace sat
 		return *this;
 	}
 
+	DeviceBuilder& DeviceBuilder::deferDestruction() noexcept
+	{
+		defer_ = true;
+		return *this;
+	}
+
+	DeviceBuilder& DeviceBuilder::pipelineCache(
+	    std::filesystem::path path) noexcept
+	{
+		cachePath_ = std::move(path);
+		return *this;
+	}
+
 	////////////////
 	//// Device ////
 	////////////////
 
 	Device::Device(const DeviceBuilder& builder)
-	    : instance_(builder.instance_), device_(builder.device_)
+	    : instance_(builder.instance_),
+	      device_(builder.device_),
+	      deferred_(builder.defer_)
 	{
 		for (const char* pExtensionName : builder.extensions_)
 		{
@@ -65,17 +87,42 @@ namespace sat
 			queueInfos.push_back(createInfo);
 		}
 
+		// Enable every supported core feature
+		VkPhysicalDeviceVulkan12Features features12 = device_.features12;
+		VkPhysicalDeviceVulkan11Features features11 = device_.features11;
+		features11.pNext                            = &features12;
+
+		// Extension features follow the core ones
+		void* pNext = nullptr;
+		for (const auto& pFeatures : builder.features_ | std::views::reverse)
+		{
+			pFeatures->pNext = static_cast<VkBaseOutStructure*>(pNext);
+			pNext            = pFeatures.get();
+		}
+
+		features12.pNext = pNext;
+
+		VkPhysicalDeviceFeatures2 features{};
+		features.sType    = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features.pNext    = &features11;
+		features.features = device_.features;
+
 		VkDeviceCreateInfo createInfo{};
 		createInfo.sType                 = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+		createInfo.pNext                 = &features;
 		createInfo.queueCreateInfoCount  = queueInfos.size();
 		createInfo.pQueueCreateInfos     = queueInfos.data();
-		createInfo.pEnabledFeatures      = &device_.features;
 		createInfo.enabledExtensionCount = builder.extensions_.size();
 		createInfo.ppEnabledExtensionNames = builder.extensions_.data();
 
 		SATURN_CALL(
 		    vkCreateDevice(device_.handle, &createInfo, nullptr, &handle_));
 
+		extensions_.assign(builder.extensions_.begin(),
+		                   builder.extensions_.end());
+		features_ = builder.features_;
+		dispatch_.load(handle_);
+
 		///////////////////
 		//// Allocator ////
 		///////////////////
@@ -96,10 +143,80 @@ namespace sat
 		{
 			vkDestroyDevice(handle_, nullptr);
 		}
+
+		//////////////////
+		//// Timeline ////
+		//////////////////
+
+		VkSemaphoreTypeCreateInfo typeInfo{};
+		typeInfo.sType         = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+		typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+		typeInfo.initialValue  = 0;
+
+		VkSemaphoreCreateInfo semaphoreInfo{};
+		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		semaphoreInfo.pNext = &typeInfo;
+
+		SATURN_CALL_NO_THROW(
+		    vkCreateSemaphore(handle_, &semaphoreInfo, nullptr, &timeline_))
+		{
+			vmaDestroyAllocator(allocator_);
+			vkDestroyDevice(handle_, nullptr);
+			throw std::runtime_error("Failed to create device timeline");
+		}
+
+		////////////////////////
+		//// Pipeline Cache ////
+		////////////////////////
+
+		try
+		{
+			pipelineCache_.reset(
+			    new PipelineCache(handle_, device_, builder.cachePath_));
+
+			layoutCache_.reset(new LayoutCache(handle_));
+			framebufferCache_.reset(new FramebufferCache(*this));
+			pipelineStats_.reset(new PipelineStats());
+		}
+		catch (...)
+		{
+			// The caches own objects of the device, so they go first
+			pipelineStats_.reset();
+			framebufferCache_.reset();
+			layoutCache_.reset();
+			pipelineCache_.reset();
+
+			vkDestroySemaphore(handle_, timeline_, nullptr);
+			vmaDestroyAllocator(allocator_);
+			vkDestroyDevice(handle_, nullptr);
+			throw;
+		}
 	}
 
 	Device::~Device() noexcept
 	{
+		vkDeviceWaitIdle(handle_);
+
+		// Everything still queued may be freed now that the device is idle
+		for (Deletion& deletion : deletions_)
+		{
+			deletion.deleter();
+		}
+
+		try
+		{
+			pipelineCache_->save();
+		}
+		catch (const std::exception&)
+		{
+			// Losing the cache only costs compile time on the next run
+		}
+
+		pipelineCache_.reset();
+		layoutCache_.reset();
+		framebufferCache_.reset();
+
+		vkDestroySemaphore(handle_, timeline_, nullptr);
 		vmaDestroyAllocator(allocator_);
 		vkDestroyDevice(handle_, nullptr);
 	}
@@ -112,8 +229,96 @@ namespace sat
 		return handle;
 	}
 
+	bool Device::hasExtension(std::string_view extensionName) const noexcept
+	{
+		return std::ranges::find(extensions_, extensionName) !=
+		       extensions_.end();
+	}
+
 	void Device::waitIdle() const
 	{
 		SATURN_CALL(vkDeviceWaitIdle(handle_));
 	}
+
+	void Device::invalidateView(VkImageView view)
+	{
+		framebufferCache_->invalidateView(view);
+
+		std::lock_guard lock(setCacheMutex_);
+
+		for (DescriptorSetCache* pCache : setCaches_)
+		{
+			pCache->invalidateView(view);
+		}
+	}
+
+	void Device::invalidateBuffer(VkBuffer buffer)
+	{
+		std::lock_guard lock(setCacheMutex_);
+
+		for (DescriptorSetCache* pCache : setCaches_)
+		{
+			pCache->invalidateBuffer(buffer);
+		}
+	}
+
+	uint64_t Device::completed() const
+	{
+		uint64_t value;
+		SATURN_CALL(vkGetSemaphoreCounterValue(handle_, timeline_, &value));
+
+		return value;
+	}
+
+	void Device::wait(uint64_t frame) const
+	{
+		VkSemaphoreWaitInfo waitInfo{};
+		waitInfo.sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+		waitInfo.semaphoreCount = 1;
+		waitInfo.pSemaphores    = &timeline_;
+		waitInfo.pValues        = &frame;
+
+		SATURN_CALL(vkWaitSemaphores(handle_, &waitInfo, UINT64_MAX));
+	}
+
+	void Device::advance()
+	{
+		++frame_;
+		collect();
+	}
+
+	void Device::collect()
+	{
+		uint64_t completed = this->completed();
+
+		std::deque<Deletion> expired;
+
+		{
+			std::lock_guard lock(mutex_);
+
+			// Deletions are queued in frame order
+			while (!deletions_.empty() && deletions_.front().frame <= completed)
+			{
+				expired.push_back(std::move(deletions_.front()));
+				deletions_.pop_front();
+			}
+		}
+
+		for (Deletion& deletion : expired)
+		{
+			deletion.deleter();
+		}
+	}
+
+	void Device::destroy(std::function<void()> deleter)
+	{
+		if (!deferred_)
+		{
+			deleter();
+			return;
+		}
+
+		std::lock_guard lock(mutex_);
+		deletions_.push_back({frame_, std::move(deleter)});
+	}
 } // namespace sat
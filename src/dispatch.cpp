@@ -0,0 +1,59 @@
+#include "dispatch.hpp"
+
+namespace sat
+{
+	namespace
+	{
+		template <typename T>
+		void load_function(VkDevice device, T& function, const char* pName)
+		{
+			function = reinterpret_cast<T>(vkGetDeviceProcAddr(device, pName));
+		}
+	} // namespace
+
+	/////////////////////////
+	//// Device Dispatch ////
+	/////////////////////////
+
+#define SATURN_LOAD(name) load_function(device, name, #name)
+
+	void DeviceDispatch::load(VkDevice device) noexcept
+	{
+		SATURN_LOAD(vkCmdSetCullModeEXT);
+		SATURN_LOAD(vkCmdSetFrontFaceEXT);
+		SATURN_LOAD(vkCmdSetPrimitiveTopologyEXT);
+		SATURN_LOAD(vkCmdSetViewportWithCountEXT);
+		SATURN_LOAD(vkCmdSetScissorWithCountEXT);
+		SATURN_LOAD(vkCmdSetDepthTestEnableEXT);
+		SATURN_LOAD(vkCmdSetDepthWriteEnableEXT);
+		SATURN_LOAD(vkCmdSetDepthCompareOpEXT);
+		SATURN_LOAD(vkCmdSetDepthBoundsTestEnableEXT);
+		SATURN_LOAD(vkCmdSetStencilTestEnableEXT);
+		SATURN_LOAD(vkCmdSetStencilOpEXT);
+
+		SATURN_LOAD(vkCmdSetRasterizerDiscardEnableEXT);
+		SATURN_LOAD(vkCmdSetDepthBiasEnableEXT);
+		SATURN_LOAD(vkCmdSetPrimitiveRestartEnableEXT);
+
+		SATURN_LOAD(vkCmdSetPolygonModeEXT);
+		SATURN_LOAD(vkCmdSetRasterizationSamplesEXT);
+		SATURN_LOAD(vkCmdSetAlphaToCoverageEnableEXT);
+		SATURN_LOAD(vkCmdSetDepthClampEnableEXT);
+		SATURN_LOAD(vkCmdSetLogicOpEnableEXT);
+		SATURN_LOAD(vkCmdSetColorBlendEnableEXT);
+		SATURN_LOAD(vkCmdSetColorBlendEquationEXT);
+		SATURN_LOAD(vkCmdSetColorWriteMaskEXT);
+		SATURN_LOAD(vkCmdSetSampleMaskEXT);
+
+		SATURN_LOAD(vkCmdSetVertexInputEXT);
+
+		SATURN_LOAD(vkCreateShadersEXT);
+		SATURN_LOAD(vkDestroyShaderEXT);
+		SATURN_LOAD(vkCmdBindShadersEXT);
+
+		SATURN_LOAD(vkCmdBeginRenderingKHR);
+		SATURN_LOAD(vkCmdEndRenderingKHR);
+	}
+
+#undef SATURN_LOAD
+} // namespace sat
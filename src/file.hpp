@@ -0,0 +1,46 @@
+#ifndef SATURN_FILE_HPP
+#define SATURN_FILE_HPP
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+
+namespace sat
+{
+	//////////////
+	//// File ////
+	//////////////
+
+	/**
+	 * \brief Replaces the file at \p path with \p bytes by renaming a fully
+	 * written temporary over it, so a crash never leaves a truncated file.
+	 */
+	inline void write_atomically(const std::filesystem::path& path,
+	                             std::string_view bytes)
+	{
+		if (path.has_parent_path())
+		{
+			std::filesystem::create_directories(path.parent_path());
+		}
+
+		std::filesystem::path temporary = path;
+		temporary += ".tmp";
+
+		{
+			std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+			file.write(bytes.data(), bytes.size());
+			file.close();
+
+			if (!file)
+			{
+				throw std::runtime_error("Failed to write " + path.string());
+			}
+		}
+
+		// Renaming over the old file is atomic
+		std::filesystem::rename(temporary, path);
+	}
+} // namespace sat
+
+#endif
@@ -50,6 +50,8 @@ namespace sat
 
 	Framebuffer::~Framebuffer() noexcept
 	{
-		vkDestroyFramebuffer(device_, handle_, nullptr);
+		device_->destroy([device = device_->handle(), handle = handle_]() {
+			vkDestroyFramebuffer(device, handle, nullptr);
+		});
 	}
 } // namespace sat
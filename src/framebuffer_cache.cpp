@@ -0,0 +1,134 @@
+#include "framebuffer_cache.hpp"
+
+#include <algorithm>
+
+#include "device.hpp"
+#include "error.hpp"
+#include "key.hpp"
+
+namespace sat
+{
+	///////////////////////////
+	//// Framebuffer Cache ////
+	///////////////////////////
+
+	FramebufferCache::FramebufferCache(Device& device) noexcept
+	    : device_(device)
+	{}
+
+	FramebufferCache::~FramebufferCache() noexcept
+	{
+		for (const auto& [key, entry] : framebuffers_)
+		{
+			vkDestroyFramebuffer(device_, entry.framebuffer, nullptr);
+		}
+	}
+
+	template <typename F>
+	void FramebufferCache::drop(F&& predicate)
+	{
+		std::vector<VkFramebuffer> expired;
+
+		{
+			std::lock_guard lock(mutex_);
+
+			std::erase_if(framebuffers_, [&](const auto& item) {
+				if (!predicate(item.second))
+				{
+					return false;
+				}
+
+				expired.push_back(item.second.framebuffer);
+				return true;
+			});
+		}
+
+		if (expired.empty())
+		{
+			return;
+		}
+
+		// Recorded frames may still use them
+		device_.destroy([device = device_.handle(), expired]() {
+			for (VkFramebuffer framebuffer : expired)
+			{
+				vkDestroyFramebuffer(device, framebuffer, nullptr);
+			}
+		});
+	}
+
+	VkFramebuffer FramebufferCache::get(VkRenderPass renderPass,
+	                                    std::span<VkImageView const> views,
+	                                    const VkExtent2D& extent)
+	{
+		Key key;
+		key << renderPass << extent.width << extent.height
+		    << static_cast<uint32_t>(views.size());
+
+		for (VkImageView view : views)
+		{
+			key << view;
+		}
+
+		std::lock_guard lock(mutex_);
+
+		auto [it, inserted] = framebuffers_.try_emplace(std::move(key).str());
+		if (!inserted)
+		{
+			return it->second.framebuffer;
+		}
+
+		VkFramebufferCreateInfo createInfo{};
+		createInfo.sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		createInfo.renderPass      = renderPass;
+		createInfo.attachmentCount = views.size();
+		createInfo.pAttachments    = views.data();
+		createInfo.width           = extent.width;
+		createInfo.height          = extent.height;
+		createInfo.layers          = 1;
+
+		Entry& entry     = it->second;
+		entry.renderPass = renderPass;
+		entry.views.assign(views.begin(), views.end());
+
+		try
+		{
+			SATURN_CALL(vkCreateFramebuffer(
+			    device_, &createInfo, nullptr, &entry.framebuffer));
+		}
+		catch (...)
+		{
+			framebuffers_.erase(it);
+			throw;
+		}
+
+		return entry.framebuffer;
+	}
+
+	VkFramebuffer FramebufferCache::get(VkRenderPass renderPass,
+	                                    VkImageView view,
+	                                    const VkExtent2D& extent)
+	{
+		return get(renderPass, std::span(&view, 1), extent);
+	}
+
+	void FramebufferCache::invalidateView(VkImageView view)
+	{
+		drop([view](const Entry& entry) {
+			return std::ranges::find(entry.views, view) != entry.views.end();
+		});
+	}
+
+	void FramebufferCache::invalidateRenderPass(VkRenderPass renderPass)
+	{
+		drop([renderPass](const Entry& entry) {
+			return entry.renderPass == renderPass;
+		});
+	}
+
+	size_t FramebufferCache::size() const
+	{
+		std::lock_guard lock(mutex_);
+		return framebuffers_.size();
+	}
+} // namespace sat
@@ -0,0 +1,151 @@
+#include "image.hpp"
+
+#include <stdexcept>
+
+#include "device.hpp"
+#include "error.hpp"
+
+namespace sat
+{
+	///////////////
+	//// Image ////
+	///////////////
+
+	VkImageAspectFlags image::aspect(VkFormat format) noexcept
+	{
+		switch (format)
+		{
+		case VK_FORMAT_D16_UNORM:
+		case VK_FORMAT_X8_D24_UNORM_PACK32:
+		case VK_FORMAT_D32_SFLOAT:
+			return VK_IMAGE_ASPECT_DEPTH_BIT;
+		case VK_FORMAT_S8_UINT:
+			return VK_IMAGE_ASPECT_STENCIL_BIT;
+		case VK_FORMAT_D16_UNORM_S8_UINT:
+		case VK_FORMAT_D24_UNORM_S8_UINT:
+		case VK_FORMAT_D32_SFLOAT_S8_UINT:
+			return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+		default:
+			return VK_IMAGE_ASPECT_COLOR_BIT;
+		}
+	}
+
+	///////////////////////
+	//// Image Builder ////
+	///////////////////////
+
+	ImageBuilder::ImageBuilder(rn<Device> device) noexcept
+	    : device_(std::move(device))
+	{}
+
+	ImageBuilder& ImageBuilder::format(VkFormat format) noexcept
+	{
+		format_ = format;
+		return *this;
+	}
+
+	ImageBuilder& ImageBuilder::extent(const VkExtent2D& extent) noexcept
+	{
+		extent_ = extent;
+		return *this;
+	}
+
+	ImageBuilder& ImageBuilder::usage(VkImageUsageFlags usage) noexcept
+	{
+		usage_ = usage;
+		return *this;
+	}
+
+	ImageBuilder& ImageBuilder::samples(VkSampleCountFlagBits samples) noexcept
+	{
+		samples_ = samples;
+		return *this;
+	}
+
+	ImageBuilder& ImageBuilder::transient() noexcept
+	{
+		transient_ = true;
+		return *this;
+	}
+
+	///////////////
+	//// Image ////
+	///////////////
+
+	Image::Image(const ImageBuilder& builder)
+	    : device_(builder.device_),
+	      format_(builder.format_),
+	      extent_(builder.extent_),
+	      samples_(builder.samples_)
+	{
+		if (format_ == VK_FORMAT_UNDEFINED)
+		{
+			throw std::invalid_argument("Image format wasn't set");
+		}
+
+		if (extent_.width == 0 || extent_.height == 0)
+		{
+			throw std::invalid_argument("Image extent must not be zero");
+		}
+
+		VkImageCreateInfo createInfo{};
+		createInfo.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		createInfo.imageType     = VK_IMAGE_TYPE_2D;
+		createInfo.format        = format_;
+		createInfo.extent        = {extent_.width, extent_.height, 1};
+		createInfo.mipLevels     = 1;
+		createInfo.arrayLayers   = 1;
+		createInfo.samples       = samples_;
+		createInfo.tiling        = VK_IMAGE_TILING_OPTIMAL;
+		createInfo.usage         = builder.usage_;
+		createInfo.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+		createInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		VmaAllocationCreateInfo allocInfo{};
+		allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+		if (builder.transient_)
+		{
+			// Falls back to device local memory where nothing is lazy
+			createInfo.usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+			allocInfo.preferredFlags = VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+		}
+
+		SATURN_CALL(vmaCreateImage(device_->allocator(),
+		                           &createInfo,
+		                           &allocInfo,
+		                           &handle_,
+		                           &allocation_,
+		                           nullptr));
+
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType    = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image    = handle_;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format   = format_;
+		viewInfo.subresourceRange.aspectMask = image::aspect(format_);
+		viewInfo.subresourceRange.levelCount = 1;
+		viewInfo.subresourceRange.layerCount = 1;
+
+		SATURN_CALL_NO_THROW(
+		    vkCreateImageView(device_, &viewInfo, nullptr, &view_))
+		{
+			vmaDestroyImage(device_->allocator(), handle_, allocation_);
+			throw std::runtime_error("Failed to create image view");
+		}
+	}
+
+	Image::~Image() noexcept
+	{
+		device_->invalidateView(view_);
+
+		device_->destroy([device     = device_->handle(),
+		                  allocator  = device_->allocator(),
+		                  handle     = handle_,
+		                  allocation = allocation_,
+		                  view       = view_]() {
+			vkDestroyImageView(device, view, nullptr);
+			vmaDestroyImage(allocator, handle, allocation);
+		});
+	}
+} // namespace sat
@@ -0,0 +1,53 @@
+#ifndef SATURN_KEY_HPP
+#define SATURN_KEY_HPP
+
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace sat
+{
+	/////////////
+	//// Key ////
+	/////////////
+
+	/**
+	 * \brief Encodes plain values into a byte string that identifies a
+	 * state, for use as a cache key. Values are written field by field so no
+	 * padding bytes end up in the key.
+	 */
+	class Key
+	{
+	public:
+		template <typename T>
+		    requires std::is_trivially_copyable_v<T>
+		Key& operator<<(const T& value)
+		{
+			bytes_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+			return *this;
+		}
+
+		Key& operator<<(std::string_view value)
+		{
+			*this << static_cast<uint32_t>(value.size());
+			bytes_.append(value);
+			return *this;
+		}
+
+		Key& operator<<(const char* pValue)
+		{
+			return *this << std::string_view(pValue ? pValue : "");
+		}
+
+		std::string str() && { return std::move(bytes_); }
+
+		const std::string& str() const& { return bytes_; }
+
+	private:
+		std::string bytes_;
+	};
+} // namespace sat
+
+#endif
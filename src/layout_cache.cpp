@@ -0,0 +1,166 @@
+#include "layout_cache.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "error.hpp"
+#include "key.hpp"
+
+namespace sat
+{
+	//////////////////////
+	//// Layout Cache ////
+	//////////////////////
+
+	LayoutCache::LayoutCache(VkDevice device) noexcept : device_(device) {}
+
+	LayoutCache::~LayoutCache() noexcept
+	{
+		for (const auto& [key, layout] : pipelineLayouts_)
+		{
+			vkDestroyPipelineLayout(device_, layout, nullptr);
+		}
+
+		for (const auto& [key, layout] : descriptorLayouts_)
+		{
+			vkDestroyDescriptorSetLayout(device_, layout, nullptr);
+		}
+	}
+
+	VkDescriptorSetLayout LayoutCache::descriptorLayout(
+	    std::span<VkDescriptorSetLayoutBinding const> bindings,
+	    std::span<VkDescriptorBindingFlags const> flags)
+	{
+		// Binding order doesn't change the layout
+		std::vector<size_t> order(bindings.size());
+		std::iota(order.begin(), order.end(), 0);
+
+		std::ranges::sort(order, {}, [&](size_t i) {
+			return bindings[i].binding;
+		});
+
+		std::vector<VkDescriptorSetLayoutBinding> sorted;
+		std::vector<VkDescriptorBindingFlags> sortedFlags;
+		VkDescriptorSetLayoutCreateFlags layoutFlags = 0;
+
+		for (size_t i : order)
+		{
+			VkDescriptorBindingFlags bindingFlags =
+			    flags.empty() ? 0 : flags[i];
+
+			sorted.push_back(bindings[i]);
+			sortedFlags.push_back(bindingFlags);
+
+			if (bindingFlags & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT)
+			{
+				layoutFlags |=
+				    VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+			}
+		}
+
+		Key key;
+		key << static_cast<uint32_t>(sorted.size());
+
+		for (size_t i = 0; i < sorted.size(); ++i)
+		{
+			const VkDescriptorSetLayoutBinding& binding = sorted[i];
+
+			key << binding.binding << binding.descriptorType
+			    << binding.descriptorCount << binding.stageFlags
+			    << sortedFlags[i] << (binding.pImmutableSamplers != nullptr);
+
+			if (binding.pImmutableSamplers != nullptr)
+			{
+				for (uint32_t i = 0; i < binding.descriptorCount; ++i)
+				{
+					key << binding.pImmutableSamplers[i];
+				}
+			}
+		}
+
+		std::lock_guard lock(mutex_);
+
+		auto [it, inserted] =
+		    descriptorLayouts_.try_emplace(std::move(key).str());
+		if (!inserted)
+		{
+			return it->second;
+		}
+
+		VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo{};
+		flagsInfo.sType =
+		    VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+		flagsInfo.bindingCount  = sortedFlags.size();
+		flagsInfo.pBindingFlags = sortedFlags.data();
+
+		VkDescriptorSetLayoutCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		createInfo.pNext = &flagsInfo;
+		createInfo.flags = layoutFlags;
+		createInfo.bindingCount = sorted.size();
+		createInfo.pBindings    = sorted.data();
+
+		try
+		{
+			SATURN_CALL(vkCreateDescriptorSetLayout(
+			    device_, &createInfo, nullptr, &it->second));
+		}
+		catch (...)
+		{
+			descriptorLayouts_.erase(it);
+			throw;
+		}
+
+		return it->second;
+	}
+
+	VkPipelineLayout LayoutCache::pipelineLayout(
+	    std::span<VkDescriptorSetLayout const> setLayouts,
+	    std::span<VkPushConstantRange const> pushConstants)
+	{
+		Key key;
+		key << static_cast<uint32_t>(setLayouts.size());
+
+		for (VkDescriptorSetLayout layout : setLayouts)
+		{
+			key << layout;
+		}
+
+		key << static_cast<uint32_t>(pushConstants.size());
+
+		for (const VkPushConstantRange& range : pushConstants)
+		{
+			key << range.stageFlags << range.offset << range.size;
+		}
+
+		std::lock_guard lock(mutex_);
+
+		auto [it, inserted] =
+		    pipelineLayouts_.try_emplace(std::move(key).str());
+		if (!inserted)
+		{
+			return it->second;
+		}
+
+		VkPipelineLayoutCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		createInfo.setLayoutCount         = setLayouts.size();
+		createInfo.pSetLayouts            = setLayouts.data();
+		createInfo.pushConstantRangeCount = pushConstants.size();
+		createInfo.pPushConstantRanges    = pushConstants.data();
+
+		try
+		{
+			SATURN_CALL(vkCreatePipelineLayout(
+			    device_, &createInfo, nullptr, &it->second));
+		}
+		catch (...)
+		{
+			pipelineLayouts_.erase(it);
+			throw;
+		}
+
+		return it->second;
+	}
+} // namespace sat
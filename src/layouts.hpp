@@ -0,0 +1,42 @@
+#ifndef SATURN_LAYOUTS_HPP
+#define SATURN_LAYOUTS_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <span>
+#include <vector>
+
+#include "core.hpp"
+#include "pipeline.hpp"
+
+namespace sat
+{
+	class Device;
+	class Shader;
+
+	/////////////////
+	//// Layouts ////
+	/////////////////
+
+	/**
+	 * \brief Fills the layouts of sets that have none and the push constant
+	 * range, when unset, from what \p shaders declare.
+	 */
+	void reflect_layouts(std::span<rn<Shader> const> shaders,
+	                     std::span<VkShaderStageFlagBits const> stages,
+	                     std::vector<DescriptorLayout>& layouts,
+	                     std::vector<VkPushConstantRange>& pushConstants);
+
+	/**
+	 * \brief Validates \p pushConstants against the device's limits and
+	 * returns the shared pipeline layout, appending the set layouts to
+	 * \p descriptorLayouts.
+	 */
+	VkPipelineLayout create_layouts(
+	    const Device& device,
+	    std::span<DescriptorLayout const> layouts,
+	    std::span<VkPushConstantRange const> pushConstants,
+	    std::vector<VkDescriptorSetLayout>& descriptorLayouts);
+} // namespace sat
+
+#endif
@@ -20,7 +20,22 @@ namespace sat
 			device.handle = handle;
 
 			vkGetPhysicalDeviceProperties(handle, &device.properties);
-			vkGetPhysicalDeviceFeatures(handle, &device.features);
+
+			// Get core features, chaining the structures of later versions
+			device.features12.sType =
+			    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+			device.features11.sType =
+			    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
+			device.features11.pNext = &device.features12;
+
+			VkPhysicalDeviceFeatures2 features{};
+			features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+			features.pNext = &device.features11;
+
+			vkGetPhysicalDeviceFeatures2(handle, &features);
+
+			device.features         = features.features;
+			device.features11.pNext = nullptr;
 
 			// Get queue family properties
 			uint32_t count;
@@ -2,14 +2,286 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <stdexcept>
+
 #include "device.hpp"
 #include "error.hpp"
+#include "image.hpp"
+#include "key.hpp"
+#include "layout_cache.hpp"
+#include "layouts.hpp"
+#include "pipeline_cache.hpp"
+#include "pipeline_stats.hpp"
 #include "render_pass.hpp"
 #include "shader.hpp"
-#include "swapchain.hpp"
 
 namespace sat
 {
+	namespace
+	{
+		/**
+		 * \brief Which parts of a graphics pipeline are being created. No
+		 * parts at all stands for a complete pipeline.
+		 */
+		struct LibraryParts
+		{
+			bool vertexInput      = false;
+			bool preRasterization = false;
+			bool fragmentShader   = false;
+			bool fragmentOutput   = false;
+
+			bool has(VkShaderStageFlagBits stage) const noexcept
+			{
+				return stage == VK_SHADER_STAGE_FRAGMENT_BIT ? fragmentShader
+				                                             : preRasterization;
+			}
+		};
+
+		LibraryParts library_parts(VkGraphicsPipelineLibraryFlagsEXT parts)
+		{
+			if (parts == 0)
+			{
+				return {true, true, true, true};
+			}
+
+			LibraryParts included;
+			included.vertexInput =
+			    parts &
+			    VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT;
+			included.preRasterization =
+			    parts &
+			    VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT;
+			included.fragmentShader =
+			    parts & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT;
+			included.fragmentOutput =
+			    parts &
+			    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT;
+
+			return included;
+		}
+
+		bool valid(const VkPipelineCreationFeedbackEXT& feedback) noexcept
+		{
+			return feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT;
+		}
+
+		std::optional<bool> cache_hit(
+		    const VkPipelineCreationFeedbackEXT& feedback) noexcept
+		{
+			constexpr VkPipelineCreationFeedbackFlags hit =
+			    VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT;
+
+			if (!valid(feedback))
+			{
+				return std::nullopt;
+			}
+
+			return (feedback.flags & hit) != 0;
+		}
+
+		/**
+		 * \brief Times one pipeline creation and records it in the device's
+		 * stats, with the driver's feedback when the extension is enabled.
+		 */
+		class FeedbackRecorder
+		{
+		public:
+			FeedbackRecorder(const Device& device,
+			                 std::span<VkPipelineShaderStageCreateInfo const>
+			                     stages)
+			    : device_(device),
+			      stages_(stages),
+			      stageFeedback_(stages.size())
+			{
+				info_.sType =
+				    VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT;
+				info_.pPipelineCreationFeedback          = &feedback_;
+				info_.pipelineStageCreationFeedbackCount = stages.size();
+				info_.pPipelineStageCreationFeedbacks = stageFeedback_.data();
+			}
+
+			/**
+			 * \brief Starts timing and returns the chain to create with.
+			 */
+			const void* begin(const void* pNext) noexcept
+			{
+				start_ = std::chrono::steady_clock::now();
+
+				if (!device_.hasExtension(
+				        VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME))
+				{
+					return pNext;
+				}
+
+				info_.pNext = pNext;
+				return &info_;
+			}
+
+			void end(std::string name, VkPipelineBindPoint bindPoint) const
+			{
+				auto elapsed = std::chrono::steady_clock::now() - start_;
+
+				PipelineFeedback feedback{};
+				feedback.name      = std::move(name);
+				feedback.bindPoint = bindPoint;
+				feedback.cacheHit  = cache_hit(feedback_);
+				feedback.duration =
+				    valid(feedback_)
+				        ? feedback_.duration
+				        : std::chrono::duration_cast<std::chrono::nanoseconds>(
+				              elapsed)
+				              .count();
+
+				for (size_t i = 0; i < stages_.size(); ++i)
+				{
+					if (!valid(stageFeedback_[i]))
+					{
+						continue;
+					}
+
+					feedback.stages.push_back({stages_[i].stage,
+					                           stageFeedback_[i].duration,
+					                           cache_hit(stageFeedback_[i])});
+				}
+
+				device_.pipelineStats().record(std::move(feedback));
+			}
+
+		private:
+			const Device& device_;
+			std::span<VkPipelineShaderStageCreateInfo const> stages_;
+			VkPipelineCreationFeedbackEXT feedback_{};
+			std::vector<VkPipelineCreationFeedbackEXT> stageFeedback_;
+			VkPipelineCreationFeedbackCreateInfoEXT info_{};
+			std::chrono::steady_clock::time_point start_;
+		};
+	} // namespace
+
+	/////////////////
+	//// Layouts ////
+	/////////////////
+
+	void reflect_layouts(std::span<rn<Shader> const> shaders,
+	                     std::span<VkShaderStageFlagBits const> stages,
+	                     std::vector<DescriptorLayout>& layouts,
+	                     std::vector<VkPushConstantRange>& pushConstants)
+	{
+		struct Binding
+		{
+			VkDescriptorType type     = VK_DESCRIPTOR_TYPE_SAMPLER;
+			uint32_t count            = 0;
+			VkShaderStageFlags stages = 0;
+		};
+
+		std::map<uint32_t, std::map<uint32_t, Binding>> sets;
+		VkPushConstantRange pushConstant{};
+
+		for (size_t i = 0; i < shaders.size(); ++i)
+		{
+			const ShaderReflection& reflection = shaders[i]->reflection();
+
+			for (const ShaderReflection::Binding& binding : reflection.bindings)
+			{
+				Binding& merged = sets[binding.set][binding.binding];
+
+				if (merged.stages != 0 && merged.type != binding.type)
+				{
+					throw std::invalid_argument(
+					    "Shader stages declare different descriptor "
+					    "types for the same binding");
+				}
+
+				// Runtime-sized arrays stay so in every stage
+				bool runtime = binding.count == 0 ||
+				               (merged.stages != 0 && merged.count == 0);
+
+				merged.type  = binding.type;
+				merged.count =
+				    runtime ? 0 : std::max(merged.count, binding.count);
+				merged.stages |= stages[i];
+			}
+
+			if (uint32_t size = reflection.pushConstantSize; size > 0)
+			{
+				pushConstant.stageFlags |= stages[i];
+				pushConstant.size = std::max(pushConstant.size, size);
+			}
+		}
+
+		for (const auto& [set, bindings] : sets)
+		{
+			if (set < layouts.size() && !layouts[set].bindings().empty())
+			{
+				continue;
+			}
+
+			DescriptorLayout layout;
+
+			for (const auto& [index, binding] : bindings)
+			{
+				if (binding.count == 0)
+				{
+					throw std::invalid_argument(
+					    "Runtime-sized descriptor arrays need a layout set "
+					    "by hand");
+				}
+
+				layout.add(binding.type, binding.stages, binding.count, index);
+			}
+
+			if (set >= layouts.size())
+			{
+				layouts.resize(set + 1);
+			}
+
+			layouts[set] = layout;
+		}
+
+		if (pushConstants.empty() && pushConstant.size > 0)
+		{
+			pushConstants.push_back(pushConstant);
+		}
+	}
+
+	VkPipelineLayout create_layouts(
+	    const Device& device,
+	    std::span<DescriptorLayout const> layouts,
+	    std::span<VkPushConstantRange const> pushConstants,
+	    std::vector<VkDescriptorSetLayout>& descriptorLayouts)
+	{
+		const uint32_t limit =
+		    device.device().properties.limits.maxPushConstantsSize;
+
+		for (const VkPushConstantRange& range : pushConstants)
+		{
+			if (range.offset % 4 != 0 || range.size % 4 != 0)
+			{
+				throw std::invalid_argument(
+				    "Push constant ranges must be aligned to 4 bytes");
+			}
+
+			if (range.size == 0 || range.offset + range.size > limit)
+			{
+				throw std::invalid_argument(
+				    "Push constant range exceeds maxPushConstantsSize");
+			}
+		}
+
+		// Layouts are owned by the device so equal ones are shared
+		LayoutCache& cache = device.layoutCache();
+
+		for (const DescriptorLayout& layout : layouts)
+		{
+			descriptorLayouts.push_back(
+			    cache.descriptorLayout(layout.bindings(), layout.flags()));
+		}
+
+		return cache.pipelineLayout(descriptorLayouts, pushConstants);
+	}
+
 	////////////////////////////
 	//// Vertex Description ////
 	////////////////////////////
@@ -71,25 +343,63 @@ namespace sat
 
 		nextBinding_ = layout.binding + 1;
 		bindings_.push_back(layout);
+		flags_.push_back(0);
+
+		return *this;
+	}
+
+	DescriptorLayout& DescriptorLayout::addBindless(
+	    VkDescriptorType type,
+	    VkShaderStageFlags stages,
+	    uint32_t count,
+	    std::optional<uint32_t> binding) noexcept
+	{
+		add(type, stages, count, binding);
+
+		flags_.back() = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+		                VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+		                VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
 
 		return *this;
 	}
 
+	////////////////////////
+	//// Specialization ////
+	////////////////////////
+
+	VkSpecializationInfo Specialization::info() const noexcept
+	{
+		VkSpecializationInfo info{};
+		info.mapEntryCount = entries_.size();
+		info.pMapEntries   = entries_.data();
+		info.dataSize      = data_.size();
+		info.pData         = data_.data();
+
+		return info;
+	}
+
 	//////////////////////////
 	//// Pipeline Builder ////
 	//////////////////////////
 
 	PipelineBuilder::PipelineBuilder(rn<Device> device,
-	                                 rn<Swapchain> swapchain,
 	                                 rn<RenderPass> renderPass) noexcept
+	    : device_(std::move(device)), renderPass_(renderPass)
+	{}
+
+	PipelineBuilder::PipelineBuilder(rn<Device> device,
+	                                 std::span<VkFormat const> colorFormats,
+	                                 VkFormat depthFormat) noexcept
 	    : device_(std::move(device)),
-	      swapchain_(std::move(swapchain)),
-	      renderPass_(renderPass)
+	      colorFormats_(colorFormats.begin(), colorFormats.end()),
+	      depthFormat_(depthFormat)
 	{}
 
-	PipelineBuilder& PipelineBuilder::addStage(VkShaderStageFlagBits stage,
-	                                           rn<Shader> shader,
-	                                           const char* pEntrypoint) noexcept
+	PipelineBuilder& PipelineBuilder::addStage(
+	    VkShaderStageFlagBits stage,
+	    rn<Shader> shader,
+	    const char* pEntrypoint,
+	    const Specialization& specialization) noexcept
 	{
 		VkPipelineShaderStageCreateInfo createInfo{};
 		createInfo.sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -98,6 +408,7 @@ namespace sat
 		createInfo.pName  = pEntrypoint;
 
 		stages_.push_back(createInfo);
+		specializations_.push_back(specialization);
 		shaders_.push_back(std::move(shader));
 
 		return *this;
@@ -125,6 +436,13 @@ namespace sat
 		return *this;
 	}
 
+	PipelineBuilder& PipelineBuilder::cullMode(
+	    VkCullModeFlags cullMode) noexcept
+	{
+		cullMode_ = cullMode;
+		return *this;
+	}
+
 	PipelineBuilder& PipelineBuilder::frontFace(VkFrontFace frontFace) noexcept
 	{
 		frontFace_ = frontFace;
@@ -137,6 +455,28 @@ namespace sat
 		return *this;
 	}
 
+	PipelineBuilder& PipelineBuilder::samples(
+	    VkSampleCountFlagBits samples) noexcept
+	{
+		samples_ = samples;
+		return *this;
+	}
+
+	PipelineBuilder& PipelineBuilder::depthTest(VkCompareOp compareOp,
+	                                            bool write) noexcept
+	{
+		depthTest_      = true;
+		depthWrite_     = write;
+		depthCompareOp_ = compareOp;
+		return *this;
+	}
+
+	PipelineBuilder& PipelineBuilder::name(std::string name) noexcept
+	{
+		name_ = std::move(name);
+		return *this;
+	}
+
 	PipelineBuilder& PipelineBuilder::vertexDescription(
 	    const VertexDescription& description) noexcept
 	{
@@ -145,9 +485,346 @@ namespace sat
 	}
 
 	PipelineBuilder& PipelineBuilder::descriptorLayout(
-	    const DescriptorLayout& layout) noexcept
+	    const DescriptorLayout& layout,
+	    uint32_t set) noexcept
 	{
-		layout_ = layout;
+		if (set >= layouts_.size())
+		{
+			layouts_.resize(set + 1);
+		}
+
+		layouts_[set] = layout;
+		return *this;
+	}
+
+	PipelineBuilder& PipelineBuilder::pushConstantRange(
+	    VkShaderStageFlags stages,
+	    uint32_t size,
+	    uint32_t offset) noexcept
+	{
+		pushConstants_.push_back({stages, offset, size});
+		return *this;
+	}
+
+	PipelineBuilder& PipelineBuilder::reflect()
+	{
+		std::vector<VkShaderStageFlagBits> stages;
+		for (const VkPipelineShaderStageCreateInfo& stage : stages_)
+		{
+			stages.push_back(stage.stage);
+		}
+
+		std::vector<bool> unset;
+		for (const DescriptorLayout& layout : layouts_)
+		{
+			unset.push_back(layout.bindings().empty());
+		}
+
+		bool hadPushConstants = !pushConstants_.empty();
+
+		reflect_layouts(shaders_, stages, layouts_, pushConstants_);
+
+		for (uint32_t set = 0; set < layouts_.size(); ++set)
+		{
+			if ((set >= unset.size() || unset[set]) &&
+			    !layouts_[set].bindings().empty())
+			{
+				reflectedSets_.push_back(set);
+			}
+		}
+
+		if (!hadPushConstants && !pushConstants_.empty())
+		{
+			reflectedPushConstants_ = true;
+		}
+
+		reflected_ = true;
+
+		if (!description_.bindings().empty())
+		{
+			return *this;
+		}
+
+		for (size_t i = 0; i < stages_.size(); ++i)
+		{
+			if (stages_[i].stage != VK_SHADER_STAGE_VERTEX_BIT)
+			{
+				continue;
+			}
+
+			const std::vector<ShaderReflection::Input>& inputs =
+			    shaders_[i]->reflection().inputs;
+
+			if (inputs.empty())
+			{
+				break;
+			}
+
+			uint32_t stride = 0;
+			for (const ShaderReflection::Input& input : inputs)
+			{
+				if (input.format == VK_FORMAT_UNDEFINED)
+				{
+					throw std::invalid_argument(
+					    "Vertex input has no matching vertex format");
+				}
+
+				stride += input.size;
+			}
+
+			VertexDescription description;
+			description.begin(stride);
+
+			uint32_t offset = 0;
+			for (const ShaderReflection::Input& input : inputs)
+			{
+				description.add(input.format, offset, input.location);
+				offset += input.size;
+			}
+
+			description_          = description.end();
+			reflectedDescription_ = true;
+			break;
+		}
+
+		return *this;
+	}
+
+	void PipelineBuilder::reflectAgain()
+	{
+		for (uint32_t set : reflectedSets_)
+		{
+			layouts_[set] = DescriptorLayout();
+		}
+
+		// Drop trailing sets that only exist because of reflection
+		while (!layouts_.empty() && layouts_.back().bindings().empty() &&
+		       std::ranges::find(reflectedSets_, layouts_.size() - 1) !=
+		           reflectedSets_.end())
+		{
+			layouts_.pop_back();
+		}
+
+		if (reflectedPushConstants_)
+		{
+			pushConstants_.clear();
+		}
+
+		if (reflectedDescription_)
+		{
+			description_ = VertexDescription();
+		}
+
+		reflectedSets_.clear();
+		reflectedPushConstants_ = false;
+		reflectedDescription_   = false;
+
+		reflect();
+	}
+
+	std::string PipelineBuilder::key() const
+	{
+		return key(0);
+	}
+
+	std::string PipelineBuilder::key(
+	    VkGraphicsPipelineLibraryFlagsEXT parts) const
+	{
+		LibraryParts included = library_parts(parts);
+
+		Key key;
+
+		VkRenderPass renderPass =
+		    renderPass_.get() ? renderPass_->handle() : VK_NULL_HANDLE;
+
+		key << parts << renderPass << subpass_;
+
+		key << static_cast<uint32_t>(colorFormats_.size());
+		for (VkFormat format : colorFormats_)
+		{
+			key << format;
+		}
+
+		key << depthFormat_;
+
+		key << static_cast<uint32_t>(stages_.size());
+		for (size_t i = 0; i < stages_.size(); ++i)
+		{
+			if (!included.has(stages_[i].stage))
+			{
+				continue;
+			}
+
+			const Specialization& specialization = specializations_[i];
+
+			key << stages_[i].stage << stages_[i].module << stages_[i].pName;
+
+			key << static_cast<uint32_t>(specialization.entries().size());
+			for (const VkSpecializationMapEntry& entry :
+			     specialization.entries())
+			{
+				key << entry.constantID << entry.offset
+				    << static_cast<uint32_t>(entry.size);
+			}
+
+			key << std::string_view(
+			    reinterpret_cast<const char*>(specialization.data().data()),
+			    specialization.data().size());
+		}
+
+		if (included.vertexInput)
+		{
+			key << static_cast<uint32_t>(description_.bindings().size());
+			for (const VkVertexInputBindingDescription& binding :
+			     description_.bindings())
+			{
+				key << binding.binding << binding.stride << binding.inputRate;
+			}
+
+			key << static_cast<uint32_t>(description_.attributes().size());
+			for (const VkVertexInputAttributeDescription& attribute :
+			     description_.attributes())
+			{
+				key << attribute.location << attribute.binding
+				    << attribute.format << attribute.offset;
+			}
+
+			key << topology_;
+		}
+
+		if (included.preRasterization || included.fragmentShader)
+		{
+			key << static_cast<uint32_t>(layouts_.size());
+			for (const DescriptorLayout& layout : layouts_)
+			{
+				key << static_cast<uint32_t>(layout.bindings().size());
+				for (size_t i = 0; i < layout.bindings().size(); ++i)
+				{
+					const VkDescriptorSetLayoutBinding& binding =
+					    layout.bindings()[i];
+
+					key << binding.binding << binding.descriptorType
+					    << binding.descriptorCount << binding.stageFlags
+					    << layout.flags()[i];
+				}
+			}
+
+			key << static_cast<uint32_t>(pushConstants_.size());
+			for (const VkPushConstantRange& range : pushConstants_)
+			{
+				key << range.stageFlags << range.offset << range.size;
+			}
+		}
+
+		key << static_cast<uint32_t>(dynamics_.size());
+		for (VkDynamicState state : dynamics_)
+		{
+			key << state;
+		}
+
+		// Static values of dynamic states don't change the pipeline
+		if (included.preRasterization)
+		{
+			if (!dynamic(VK_DYNAMIC_STATE_POLYGON_MODE_EXT))
+			{
+				key << polygonMode_;
+			}
+
+			if (!dynamic(VK_DYNAMIC_STATE_CULL_MODE_EXT))
+			{
+				key << cullMode_;
+			}
+
+			if (!dynamic(VK_DYNAMIC_STATE_FRONT_FACE_EXT))
+			{
+				key << frontFace_;
+			}
+		}
+
+		if (included.fragmentShader || included.fragmentOutput)
+		{
+			key << samples_;
+		}
+
+		if (included.fragmentShader)
+		{
+			if (!dynamic(VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT))
+			{
+				key << depthTest_;
+			}
+
+			if (!dynamic(VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT))
+			{
+				key << depthWrite_;
+			}
+
+			if (!dynamic(VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT))
+			{
+				key << depthCompareOp_;
+			}
+		}
+
+		return std::move(key).str();
+	}
+
+	bool PipelineBuilder::dynamic(VkDynamicState state) const noexcept
+	{
+		return std::ranges::find(dynamics_, state) != dynamics_.end();
+	}
+
+	//////////////////////////////////
+	//// Compute Pipeline Builder ////
+	//////////////////////////////////
+
+	ComputePipelineBuilder::ComputePipelineBuilder(rn<Device> device) noexcept
+	    : device_(std::move(device))
+	{}
+
+	ComputePipelineBuilder& ComputePipelineBuilder::shader(
+	    rn<Shader> shader,
+	    const char* pEntrypoint,
+	    const Specialization& specialization) noexcept
+	{
+		shader_         = std::move(shader);
+		pEntrypoint_    = pEntrypoint;
+		specialization_ = specialization;
+		return *this;
+	}
+
+	ComputePipelineBuilder& ComputePipelineBuilder::descriptorLayout(
+	    const DescriptorLayout& layout,
+	    uint32_t set) noexcept
+	{
+		if (set >= layouts_.size())
+		{
+			layouts_.resize(set + 1);
+		}
+
+		layouts_[set] = layout;
+		return *this;
+	}
+
+	ComputePipelineBuilder& ComputePipelineBuilder::name(
+	    std::string name) noexcept
+	{
+		name_ = std::move(name);
+		return *this;
+	}
+
+	ComputePipelineBuilder& ComputePipelineBuilder::reflect()
+	{
+		const VkShaderStageFlagBits stage = VK_SHADER_STAGE_COMPUTE_BIT;
+
+		reflect_layouts({&shader_, 1}, {&stage, 1}, layouts_, pushConstants_);
+		return *this;
+	}
+
+	ComputePipelineBuilder& ComputePipelineBuilder::pushConstantRange(
+	    VkShaderStageFlags stages,
+	    uint32_t size,
+	    uint32_t offset) noexcept
+	{
+		pushConstants_.push_back({stages, offset, size});
 		return *this;
 	}
 
@@ -156,10 +833,45 @@ namespace sat
 	//////////////////
 
 	Pipeline::Pipeline(const PipelineBuilder& builder)
+	    : Pipeline(builder, 0, {}, 0)
+	{}
+
+	Pipeline::Pipeline(const PipelineBuilder& builder,
+	                   VkGraphicsPipelineLibraryFlagsEXT parts,
+	                   std::span<VkPipeline const> libraries,
+	                   VkPipelineCreateFlags flags)
 	    : device_(builder.device_),
-	      swapchain_(builder.swapchain_),
-	      renderPass_(builder.renderPass_)
+	      renderPass_(builder.renderPass_),
+	      shaders_(builder.shaders_),
+	      bindPoint_(VK_PIPELINE_BIND_POINT_GRAPHICS)
 	{
+		// Linking takes all of its state from the libraries
+		LibraryParts included =
+		    libraries.empty() ? library_parts(parts) : LibraryParts{};
+
+		// Specialization infos point into the builder, which outlives the call
+		std::vector<VkPipelineShaderStageCreateInfo> stages;
+		std::vector<VkSpecializationInfo> specializations(
+		    builder.stages_.size());
+
+		for (size_t i = 0; i < builder.stages_.size(); ++i)
+		{
+			VkPipelineShaderStageCreateInfo stage = builder.stages_[i];
+
+			if (!included.has(stage.stage))
+			{
+				continue;
+			}
+
+			if (!builder.specializations_[i].empty())
+			{
+				specializations[i]        = builder.specializations_[i].info();
+				stage.pSpecializationInfo = &specializations[i];
+			}
+
+			stages.push_back(stage);
+		}
+
 		VkPipelineVertexInputStateCreateInfo vertexInputState{};
 		vertexInputState.sType =
 		    VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
@@ -178,27 +890,36 @@ namespace sat
 		inputAssemblyState.topology               = builder.topology_;
 		inputAssemblyState.primitiveRestartEnable = VK_FALSE;
 
+		// Viewports and scissors are always dynamic, either with a fixed
+		// count of one or with the count set while recording
+		bool viewportWithCount =
+		    builder.dynamic(VK_DYNAMIC_STATE_VIEWPORT_WITH_COUNT_EXT);
+		bool scissorWithCount =
+		    builder.dynamic(VK_DYNAMIC_STATE_SCISSOR_WITH_COUNT_EXT);
+
+		std::vector<VkDynamicState> dynamics = builder.dynamics_;
+
+		if (!viewportWithCount && !builder.dynamic(VK_DYNAMIC_STATE_VIEWPORT))
+		{
+			dynamics.push_back(VK_DYNAMIC_STATE_VIEWPORT);
+		}
+
+		if (!scissorWithCount && !builder.dynamic(VK_DYNAMIC_STATE_SCISSOR))
+		{
+			dynamics.push_back(VK_DYNAMIC_STATE_SCISSOR);
+		}
+
 		VkPipelineDynamicStateCreateInfo dynamicState{};
 		dynamicState.sType =
 		    VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-		dynamicState.dynamicStateCount = builder.dynamics_.size();
-		dynamicState.pDynamicStates    = builder.dynamics_.data();
-
-		VkViewport viewport{};
-		viewport.width    = swapchain_->extent().width;
-		viewport.height   = swapchain_->extent().height;
-		viewport.maxDepth = 1;
-
-		VkRect2D scissor{};
-		scissor.extent = swapchain_->extent();
+		dynamicState.dynamicStateCount = dynamics.size();
+		dynamicState.pDynamicStates    = dynamics.data();
 
 		VkPipelineViewportStateCreateInfo viewportState{};
 		viewportState.sType =
 		    VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-		viewportState.viewportCount = 1;
-		viewportState.pViewports    = &viewport;
-		viewportState.scissorCount  = 1;
-		viewportState.pScissors     = &scissor;
+		viewportState.viewportCount = viewportWithCount ? 0 : 1;
+		viewportState.scissorCount  = scissorWithCount ? 0 : 1;
 
 		VkPipelineRasterizationStateCreateInfo rasterizationState{};
 		rasterizationState.sType =
@@ -207,15 +928,22 @@ namespace sat
 		rasterizationState.rasterizerDiscardEnable = VK_FALSE;
 		rasterizationState.polygonMode             = builder.polygonMode_;
 		rasterizationState.lineWidth               = 1;
-		rasterizationState.cullMode                = VK_CULL_MODE_BACK_BIT;
-		rasterizationState.frontFace               = VK_FRONT_FACE_CLOCKWISE;
+		rasterizationState.cullMode                = builder.cullMode_;
+		rasterizationState.frontFace               = builder.frontFace_;
 		rasterizationState.depthBiasEnable         = VK_FALSE;
 
 		VkPipelineMultisampleStateCreateInfo multisampleState{};
 		multisampleState.sType =
 		    VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
 		multisampleState.sampleShadingEnable  = VK_FALSE;
-		multisampleState.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+		multisampleState.rasterizationSamples = builder.samples_;
+
+		VkPipelineDepthStencilStateCreateInfo depthStencilState{};
+		depthStencilState.sType =
+		    VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+		depthStencilState.depthTestEnable  = builder.depthTest_;
+		depthStencilState.depthWriteEnable = builder.depthWrite_;
+		depthStencilState.depthCompareOp   = builder.depthCompareOp_;
 
 		VkPipelineColorBlendAttachmentState colorBlendAttachment{};
 		colorBlendAttachment.colorWriteMask =
@@ -223,81 +951,171 @@ namespace sat
 		    VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
 		colorBlendAttachment.blendEnable = VK_FALSE;
 
+		// Dynamic rendering needs a blend state per color attachment
+		std::vector<VkPipelineColorBlendAttachmentState> colorBlendAttachments(
+		    renderPass_.get() ? 1 : builder.colorFormats_.size(),
+		    colorBlendAttachment);
+
 		VkPipelineColorBlendStateCreateInfo colorBlendState{};
 		colorBlendState.sType =
 		    VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
 		colorBlendState.logicOpEnable   = VK_FALSE;
-		colorBlendState.attachmentCount = 1;
-		colorBlendState.pAttachments    = &colorBlendAttachment;
+		colorBlendState.attachmentCount = colorBlendAttachments.size();
+		colorBlendState.pAttachments    = colorBlendAttachments.data();
 
 		VkGraphicsPipelineCreateInfo createInfo{};
 		createInfo.sType      = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-		createInfo.stageCount = builder.stages_.size();
-		createInfo.pStages    = builder.stages_.data();
-		createInfo.pVertexInputState   = &vertexInputState;
-		createInfo.pInputAssemblyState = &inputAssemblyState;
-		createInfo.pViewportState      = &viewportState;
-		createInfo.pRasterizationState = &rasterizationState;
-		createInfo.pMultisampleState   = &multisampleState;
-		createInfo.pColorBlendState    = &colorBlendState;
-		createInfo.pDynamicState       = &dynamicState;
-		createInfo.renderPass          = renderPass_;
-		createInfo.subpass             = builder.subpass_;
-
-		///////////////////////////////
-		//// Descriptor Set Layout ////
-		///////////////////////////////
-
-		VkDescriptorSetLayoutCreateInfo descriptorLayoutInfo{};
-		descriptorLayoutInfo.sType =
-		    VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-		descriptorLayoutInfo.bindingCount = builder.layout_.bindings().size();
-		descriptorLayoutInfo.pBindings    = builder.layout_.bindings().data();
-
-		SATURN_CALL(vkCreateDescriptorSetLayout(
-		    device_, &descriptorLayoutInfo, nullptr, &descriptorLayout_));
-
-		/////////////////////////
-		//// Pipeline Layout ////
-		/////////////////////////
-
-		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-		pipelineLayoutInfo.sType =
-		    VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-		pipelineLayoutInfo.setLayoutCount = 1;
-		pipelineLayoutInfo.pSetLayouts    = &descriptorLayout_;
-
-		SATURN_CALL_NO_THROW(vkCreatePipelineLayout(
-		    device_, &pipelineLayoutInfo, nullptr, &pipelineLayout_))
-		{
-			goto layout_failed;
-		}
-
-		//////////////////
-		//// Pipeline ////
-		//////////////////
+		createInfo.flags      = flags;
+		createInfo.stageCount = stages.size();
+		createInfo.pStages    = stages.data();
 
+		if (included.vertexInput)
+		{
+			createInfo.pVertexInputState   = &vertexInputState;
+			createInfo.pInputAssemblyState = &inputAssemblyState;
+		}
+
+		if (included.preRasterization)
+		{
+			createInfo.pViewportState      = &viewportState;
+			createInfo.pRasterizationState = &rasterizationState;
+		}
+
+		if (included.fragmentShader || included.fragmentOutput)
+		{
+			createInfo.pMultisampleState = &multisampleState;
+		}
+
+		if (included.fragmentShader)
+		{
+			createInfo.pDepthStencilState = &depthStencilState;
+		}
+
+		if (included.fragmentOutput)
+		{
+			createInfo.pColorBlendState = &colorBlendState;
+		}
+
+		if (libraries.empty())
+		{
+			createInfo.pDynamicState = &dynamicState;
+			createInfo.subpass       = builder.subpass_;
+
+			if (renderPass_.get())
+			{
+				createInfo.renderPass = renderPass_;
+			}
+		}
+
+		createLayouts(builder.layouts_, builder.pushConstants_);
 		createInfo.layout = pipelineLayout_;
 
-		SATURN_CALL_NO_THROW(vkCreateGraphicsPipelines(
-		    device_, VK_NULL_HANDLE, 1, &createInfo, nullptr, &handle_))
+		VkGraphicsPipelineLibraryCreateInfoEXT libraryInfo{};
+		libraryInfo.sType =
+		    VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT;
+		libraryInfo.flags = parts;
+
+		VkPipelineLibraryCreateInfoKHR linkInfo{};
+		linkInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR;
+		linkInfo.libraryCount = libraries.size();
+		linkInfo.pLibraries   = libraries.data();
+
+		if (parts != 0)
+		{
+			// Parts keep what an optimized link needs to recompile them
+			createInfo.pNext = &libraryInfo;
+			createInfo.flags |=
+			    VK_PIPELINE_CREATE_LIBRARY_BIT_KHR |
+			    VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+		}
+		else if (!libraries.empty())
 		{
-			goto pipeline_failed;
+			createInfo.pNext = &linkInfo;
 		}
 
-		return;
+		VkPipelineRenderingCreateInfoKHR renderingInfo{};
+		renderingInfo.sType =
+		    VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+		renderingInfo.colorAttachmentCount    = builder.colorFormats_.size();
+		renderingInfo.pColorAttachmentFormats = builder.colorFormats_.data();
+		renderingInfo.depthAttachmentFormat   = builder.depthFormat_;
+
+		if (image::aspect(builder.depthFormat_) & VK_IMAGE_ASPECT_STENCIL_BIT)
+		{
+			renderingInfo.stencilAttachmentFormat = builder.depthFormat_;
+		}
+
+		if (!renderPass_.get() && libraries.empty())
+		{
+			renderingInfo.pNext = createInfo.pNext;
+			createInfo.pNext    = &renderingInfo;
+		}
 
-	layout_failed:
-		vkDestroyPipelineLayout(device_, pipelineLayout_, nullptr);
+		FeedbackRecorder recorder(*device_.get(), stages);
+		createInfo.pNext = recorder.begin(createInfo.pNext);
 
-	pipeline_failed:
-		vkDestroyPipeline(device_, handle_, nullptr);
+		auto cacheLock = device_->pipelineCache().use();
+
+		SATURN_CALL(vkCreateGraphicsPipelines(device_,
+		                                      device_->pipelineCache(),
+		                                      1,
+		                                      &createInfo,
+		                                      nullptr,
+		                                      &handle_));
+
+		recorder.end(builder.name_, bindPoint_);
+	}
+
+	Pipeline::Pipeline(const ComputePipelineBuilder& builder)
+	    : device_(builder.device_),
+	      shaders_{builder.shader_},
+	      bindPoint_(VK_PIPELINE_BIND_POINT_COMPUTE)
+	{
+		createLayouts(builder.layouts_, builder.pushConstants_);
+
+		VkComputePipelineCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		createInfo.stage.sType =
+		    VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		createInfo.stage.stage  = VK_SHADER_STAGE_COMPUTE_BIT;
+		createInfo.stage.module = builder.shader_;
+		createInfo.stage.pName  = builder.pEntrypoint_;
+		createInfo.layout       = pipelineLayout_;
+
+		VkSpecializationInfo specialization = builder.specialization_.info();
+
+		if (!builder.specialization_.empty())
+		{
+			createInfo.stage.pSpecializationInfo = &specialization;
+		}
+
+		FeedbackRecorder recorder(*device_.get(), {&createInfo.stage, 1});
+		createInfo.pNext = recorder.begin(createInfo.pNext);
+
+		auto cacheLock = device_->pipelineCache().use();
+
+		SATURN_CALL(vkCreateComputePipelines(device_,
+		                                     device_->pipelineCache(),
+		                                     1,
+		                                     &createInfo,
+		                                     nullptr,
+		                                     &handle_));
+
+		recorder.end(builder.name_, bindPoint_);
+	}
+
+	void Pipeline::createLayouts(
+	    std::span<DescriptorLayout const> layouts,
+	    std::span<VkPushConstantRange const> pushConstants)
+	{
+		pipelineLayout_ = create_layouts(
+		    *device_.get(), layouts, pushConstants, descriptorLayouts_);
 	}
 
 	Pipeline::~Pipeline() noexcept
 	{
-		vkDestroyPipeline(device_, handle_, nullptr);
-		vkDestroyPipelineLayout(device_, pipelineLayout_, nullptr);
-		vkDestroyDescriptorSetLayout(device_, descriptorLayout_, nullptr);
+		device_->destroy([device = device_->handle(), handle = handle_]() {
+			vkDestroyPipeline(device, handle, nullptr);
+		});
 	}
 } // namespace sat
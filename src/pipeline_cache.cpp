@@ -0,0 +1,149 @@
+#include "pipeline_cache.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "error.hpp"
+#include "file.hpp"
+
+namespace sat
+{
+	namespace
+	{
+		std::vector<uint8_t> read_cache(const std::filesystem::path& path)
+		{
+			std::ifstream file(path, std::ios::binary);
+			if (!file.is_open())
+			{
+				return {};
+			}
+
+			return std::vector<uint8_t>(std::istreambuf_iterator<char>(file),
+			                            std::istreambuf_iterator<char>());
+		}
+
+		/**
+		 * \brief Checks that cache data was written by the same driver and
+		 * device, as data from any other is useless at best.
+		 */
+		bool validate_cache(std::span<uint8_t const> data,
+		                    const VkPhysicalDeviceProperties& properties)
+		{
+			VkPipelineCacheHeaderVersionOne header;
+
+			if (data.size() < sizeof(header))
+			{
+				return false;
+			}
+
+			std::memcpy(&header, data.data(), sizeof(header));
+
+			return header.headerSize >= sizeof(header) &&
+			       header.headerSize <= data.size() &&
+			       header.headerVersion ==
+			           VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+			       header.vendorID == properties.vendorID &&
+			       header.deviceID == properties.deviceID &&
+			       std::memcmp(header.pipelineCacheUUID,
+			                   properties.pipelineCacheUUID,
+			                   VK_UUID_SIZE) == 0;
+		}
+	} // namespace
+
+	////////////////////////
+	//// Pipeline Cache ////
+	////////////////////////
+
+	PipelineCache::PipelineCache(VkDevice device,
+	                             const PhysicalDevice& physicalDevice,
+	                             std::filesystem::path path)
+	    : device_(device), path_(std::move(path))
+	{
+		std::vector<uint8_t> data;
+
+		if (!path_.empty())
+		{
+			data = read_cache(path_);
+
+			if (!validate_cache(data, physicalDevice.properties))
+			{
+				data.clear();
+			}
+		}
+
+		VkPipelineCacheCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		createInfo.initialDataSize = data.size();
+		createInfo.pInitialData    = data.data();
+
+		SATURN_CALL(
+		    vkCreatePipelineCache(device_, &createInfo, nullptr, &handle_));
+	}
+
+	PipelineCache::~PipelineCache() noexcept
+	{
+		vkDestroyPipelineCache(device_, handle_, nullptr);
+	}
+
+	VkPipelineCache PipelineCache::fork() const
+	{
+		VkPipelineCacheCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+
+		VkPipelineCache cache;
+		SATURN_CALL(
+		    vkCreatePipelineCache(device_, &createInfo, nullptr, &cache));
+
+		return cache;
+	}
+
+	void PipelineCache::merge(std::span<VkPipelineCache const> caches)
+	{
+		{
+			std::lock_guard lock(mutex_);
+
+			SATURN_CALL(vkMergePipelineCaches(
+			    device_, handle_, caches.size(), caches.data()));
+		}
+
+		for (VkPipelineCache cache : caches)
+		{
+			vkDestroyPipelineCache(device_, cache, nullptr);
+		}
+	}
+
+	std::shared_lock<std::shared_mutex> PipelineCache::use() const
+	{
+		return std::shared_lock(mutex_);
+	}
+
+	void PipelineCache::save()
+	{
+		if (path_.empty())
+		{
+			return;
+		}
+
+		std::vector<uint8_t> data;
+
+		{
+			// Reading the data may overlap with creating pipelines
+			std::shared_lock lock(mutex_);
+
+			size_t size;
+			SATURN_CALL(
+			    vkGetPipelineCacheData(device_, handle_, &size, nullptr));
+
+			data.resize(size);
+			SATURN_CALL(
+			    vkGetPipelineCacheData(device_, handle_, &size, data.data()));
+			data.resize(size);
+		}
+
+		write_atomically(
+		    path_,
+		    {reinterpret_cast<const char*>(data.data()), data.size()});
+	}
+} // namespace sat
@@ -0,0 +1,34 @@
+#include "pipeline_compiler.hpp"
+
+namespace sat
+{
+	///////////////////////////
+	//// Pipeline Compiler ////
+	///////////////////////////
+
+	PipelineCompiler::PipelineCompiler(unsigned threads)
+	    : pool_(threads)
+	{}
+
+	std::future<rn<Pipeline>> PipelineCompiler::compile(
+	    PipelineBuilder builder)
+	{
+		// The builder is copied into the task, so the caller's may go away
+		return pool_.submit(
+		    [builder = std::move(builder)]() { return builder.build(); });
+	}
+
+	std::vector<std::future<rn<Pipeline>>> PipelineCompiler::compile(
+	    std::span<PipelineBuilder const> builders)
+	{
+		std::vector<std::future<rn<Pipeline>>> futures;
+		futures.reserve(builders.size());
+
+		for (const PipelineBuilder& builder : builders)
+		{
+			futures.push_back(compile(builder));
+		}
+
+		return futures;
+	}
+} // namespace sat
@@ -0,0 +1,171 @@
+#include "pipeline_library.hpp"
+
+#include <array>
+
+#include "device.hpp"
+#include "pipeline_manifest.hpp"
+
+namespace sat
+{
+	namespace
+	{
+		/**
+		 * \brief Whether \p device has enabled graphics pipeline libraries,
+		 * which takes both extensions and the feature.
+		 */
+		bool supports_libraries(const Device& device) noexcept
+		{
+			const auto* pFeatures = device.features<
+			    VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>(
+			    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT);
+
+			return device.hasExtension(
+			           VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+			       device.hasExtension(
+			           VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+			       pFeatures && pFeatures->graphicsPipelineLibrary;
+		}
+	} // namespace
+
+	//////////////////////////
+	//// Pipeline Library ////
+	//////////////////////////
+
+	PipelineLibrary::PipelineLibrary(rn<Device> device, unsigned threads)
+	    : device_(std::move(device)),
+	      supported_(supports_libraries(*device_.get())),
+	      pool_(threads)
+	{}
+
+	PipelineLibrary::~PipelineLibrary() noexcept
+	{
+		// Pending optimized builds are no longer wanted
+		stopping_ = true;
+	}
+
+	rn<Pipeline> PipelineLibrary::get(const PipelineBuilder& builder)
+	{
+		std::string key = builder.key();
+
+		{
+			std::lock_guard lock(mutex_);
+
+			auto it = pipelines_.find(key);
+			if (it != pipelines_.end())
+			{
+				return it->second;
+			}
+		}
+
+		if (!supported_)
+		{
+			rn<Pipeline> pipeline = builder.build();
+
+			std::lock_guard lock(mutex_);
+
+			auto [it, inserted] =
+			    pipelines_.try_emplace(key, std::move(pipeline));
+
+			if (inserted && pManifest_)
+			{
+				pManifest_->record(builder);
+			}
+
+			return it->second;
+		}
+
+		std::array<VkGraphicsPipelineLibraryFlagsEXT, 4> flags{
+		    VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT,
+		    VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT,
+		    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT,
+		    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT,
+		};
+
+		std::array<rn<Pipeline>, 4> parts;
+		std::array<VkPipeline, 4> libraries;
+
+		for (size_t i = 0; i < parts.size(); ++i)
+		{
+			parts[i]     = part(builder, flags[i]);
+			libraries[i] = parts[i]->handle();
+		}
+
+		rn<Pipeline> pipeline(new Pipeline(builder, 0, libraries, 0));
+
+		{
+			std::lock_guard lock(mutex_);
+
+			auto [it, inserted] = pipelines_.try_emplace(key, pipeline);
+			if (!inserted)
+			{
+				return it->second;
+			}
+
+			if (pManifest_)
+			{
+				pManifest_->record(builder);
+			}
+		}
+
+		// The parts are captured so they outlive the optimized link
+		pool_.submit([this, builder, key, parts, libraries]() {
+			if (stopping_)
+			{
+				return;
+			}
+
+			try
+			{
+				rn<Pipeline> optimized(new Pipeline(
+				    builder,
+				    0,
+				    libraries,
+				    VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT));
+
+				std::lock_guard lock(mutex_);
+				pipelines_[key] = std::move(optimized);
+			}
+			catch (const std::exception& e)
+			{
+				std::lock_guard lock(mutex_);
+				errors_.push_back(e.what());
+			}
+		});
+
+		return pipeline;
+	}
+
+	void PipelineLibrary::record(PipelineManifest* pManifest) noexcept
+	{
+		std::lock_guard lock(mutex_);
+		pManifest_ = pManifest;
+	}
+
+	std::vector<std::string> PipelineLibrary::errors() const
+	{
+		std::lock_guard lock(mutex_);
+		return errors_;
+	}
+
+	rn<Pipeline> PipelineLibrary::part(const PipelineBuilder& builder,
+	                                   VkGraphicsPipelineLibraryFlagsEXT part)
+	{
+		std::string key = builder.key(part);
+
+		{
+			std::lock_guard lock(mutex_);
+
+			auto it = parts_.find(key);
+			if (it != parts_.end())
+			{
+				return it->second;
+			}
+		}
+
+		rn<Pipeline> library(new Pipeline(builder, part, {}, 0));
+
+		std::lock_guard lock(mutex_);
+		return parts_.try_emplace(std::move(key), std::move(library))
+		    .first->second;
+	}
+} // namespace sat
@@ -0,0 +1,530 @@
+#include "pipeline_manifest.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "file.hpp"
+#include "key.hpp"
+#include "pipeline_compiler.hpp"
+#include "pipeline_registry.hpp"
+#include "render_pass.hpp"
+#include "shader.hpp"
+
+namespace sat
+{
+	namespace
+	{
+		constexpr uint32_t manifest_magic   = 0x4D505453; // "STPM"
+		constexpr uint32_t manifest_version = 3;
+
+		/**
+		 * \brief Reads back values written with \ref Key.
+		 */
+		class Reader
+		{
+		public:
+			explicit Reader(std::string_view bytes) noexcept
+			    : bytes_(bytes)
+			{}
+
+			template <typename T>
+			    requires std::is_trivially_copyable_v<T>
+			T read()
+			{
+				if (bytes_.size() < sizeof(T))
+				{
+					throw std::runtime_error("Truncated pipeline manifest");
+				}
+
+				T value;
+				std::memcpy(&value, bytes_.data(), sizeof(T));
+				bytes_.remove_prefix(sizeof(T));
+
+				return value;
+			}
+
+			std::string_view string()
+			{
+				uint32_t size = read<uint32_t>();
+
+				if (bytes_.size() < size)
+				{
+					throw std::runtime_error("Truncated pipeline manifest");
+				}
+
+				std::string_view value = bytes_.substr(0, size);
+				bytes_.remove_prefix(size);
+
+				return value;
+			}
+
+			/**
+			 * \brief Reads a bool, which is written as a single byte.
+			 */
+			bool flag()
+			{
+				auto value = read<uint8_t>();
+
+				if (value > 1)
+				{
+					throw std::runtime_error("Corrupt pipeline manifest");
+				}
+
+				return value == 1;
+			}
+
+			bool done() const noexcept { return bytes_.empty(); }
+
+		private:
+			std::string_view bytes_;
+		};
+	} // namespace
+
+	///////////////////////////
+	//// Pipeline Manifest ////
+	///////////////////////////
+
+	PipelineManifest::PipelineManifest(rn<Device> device) noexcept
+	    : device_(std::move(device))
+	{}
+
+	PipelineManifest& PipelineManifest::shader(std::string name,
+	                                           rn<Shader> shader)
+	{
+		std::lock_guard lock(mutex_);
+
+		shaderNames_[shader->handle()] = name;
+		shaders_[std::move(name)]      = std::move(shader);
+
+		return *this;
+	}
+
+	PipelineManifest& PipelineManifest::renderPass(std::string name,
+	                                               rn<RenderPass> renderPass)
+	{
+		std::lock_guard lock(mutex_);
+
+		renderPassNames_[renderPass->handle()] = name;
+		renderPasses_[std::move(name)]         = std::move(renderPass);
+
+		return *this;
+	}
+
+	bool PipelineManifest::record(const PipelineBuilder& builder)
+	{
+		std::lock_guard lock(mutex_);
+
+		std::optional<std::string> state = serialize(builder);
+		if (!state)
+		{
+			return false;
+		}
+
+		states_.insert(std::move(*state));
+		return true;
+	}
+
+	void PipelineManifest::save(const std::filesystem::path& path) const
+	{
+		Key file;
+
+		{
+			std::lock_guard lock(mutex_);
+
+			file << manifest_magic << manifest_version
+			     << static_cast<uint32_t>(states_.size());
+
+			for (const std::string& state : states_)
+			{
+				file << std::string_view(state);
+			}
+		}
+
+		write_atomically(path, file.str());
+	}
+
+	bool PipelineManifest::load(const std::filesystem::path& path)
+	{
+		std::ifstream in(path, std::ios::binary);
+		if (!in.is_open())
+		{
+			return false;
+		}
+
+		std::string bytes(std::istreambuf_iterator<char>(in),
+		                  std::istreambuf_iterator<char>{});
+
+		std::vector<std::string> states;
+
+		try
+		{
+			Reader reader(bytes);
+
+			if (reader.read<uint32_t>() != manifest_magic ||
+			    reader.read<uint32_t>() != manifest_version)
+			{
+				return false;
+			}
+
+			uint32_t count = reader.read<uint32_t>();
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				states.emplace_back(reader.string());
+			}
+		}
+		catch (const std::runtime_error&)
+		{
+			return false;
+		}
+
+		std::lock_guard lock(mutex_);
+		states_.insert(std::make_move_iterator(states.begin()),
+		               std::make_move_iterator(states.end()));
+
+		return true;
+	}
+
+	size_t PipelineManifest::compile(PipelineCompiler& compiler,
+	                                 PipelineRegistry& registry) const
+	{
+		std::vector<PipelineBuilder> builders;
+
+		{
+			std::lock_guard lock(mutex_);
+
+			for (const std::string& state : states_)
+			{
+				std::optional<PipelineBuilder> builder = deserialize(state);
+
+				if (builder)
+				{
+					builders.push_back(std::move(*builder));
+				}
+			}
+		}
+
+		std::vector<std::future<rn<Pipeline>>> futures;
+		futures.reserve(builders.size());
+
+		for (const PipelineBuilder& builder : builders)
+		{
+			futures.push_back(compiler.pool().submit(
+			    [&registry, &builder]() { return registry.get(builder); }));
+		}
+
+		return ThreadPool::wait(futures).size();
+	}
+
+	size_t PipelineManifest::size() const
+	{
+		std::lock_guard lock(mutex_);
+		return states_.size();
+	}
+
+	std::optional<std::string> PipelineManifest::serialize(
+	    const PipelineBuilder& builder) const
+	{
+		// Pipelines for dynamic rendering have no render pass to name
+		std::string_view renderPassName;
+
+		if (builder.renderPass_.get())
+		{
+			auto renderPass =
+			    renderPassNames_.find(builder.renderPass_->handle());
+			if (renderPass == renderPassNames_.end())
+			{
+				return std::nullopt;
+			}
+
+			renderPassName = renderPass->second;
+		}
+
+		Key state;
+
+		state << std::string_view(builder.name_) << renderPassName
+		      << builder.subpass_;
+
+		state << static_cast<uint32_t>(builder.colorFormats_.size());
+		for (VkFormat format : builder.colorFormats_)
+		{
+			state << format;
+		}
+
+		state << builder.depthFormat_;
+
+		state << static_cast<uint32_t>(builder.stages_.size());
+		for (size_t i = 0; i < builder.stages_.size(); ++i)
+		{
+			const VkPipelineShaderStageCreateInfo& stage = builder.stages_[i];
+			const Specialization& specialization =
+			    builder.specializations_[i];
+
+			auto shader = shaderNames_.find(stage.module);
+			if (shader == shaderNames_.end())
+			{
+				return std::nullopt;
+			}
+
+			state << stage.stage << std::string_view(shader->second)
+			      << stage.pName;
+
+			state << static_cast<uint32_t>(specialization.entries_.size());
+			for (const VkSpecializationMapEntry& entry :
+			     specialization.entries_)
+			{
+				state << entry.constantID << entry.offset
+				      << static_cast<uint32_t>(entry.size);
+			}
+
+			state << std::string_view(
+			    reinterpret_cast<const char*>(specialization.data_.data()),
+			    specialization.data_.size());
+		}
+
+		const VertexDescription& description = builder.description_;
+
+		state << static_cast<uint32_t>(description.bindings_.size());
+		for (const VkVertexInputBindingDescription& binding :
+		     description.bindings_)
+		{
+			state << binding.binding << binding.stride << binding.inputRate;
+		}
+
+		state << static_cast<uint32_t>(description.attributes_.size());
+		for (const VkVertexInputAttributeDescription& attribute :
+		     description.attributes_)
+		{
+			state << attribute.location << attribute.binding
+			      << attribute.format << attribute.offset;
+		}
+
+		state << builder.topology_ << builder.polygonMode_ << builder.cullMode_
+		      << builder.frontFace_ << builder.samples_;
+
+		state << builder.depthTest_ << builder.depthWrite_
+		      << builder.depthCompareOp_;
+
+		state << static_cast<uint32_t>(builder.dynamics_.size());
+		for (VkDynamicState dynamic : builder.dynamics_)
+		{
+			state << dynamic;
+		}
+
+		state << static_cast<uint32_t>(builder.layouts_.size());
+		for (const DescriptorLayout& layout : builder.layouts_)
+		{
+			state << static_cast<uint32_t>(layout.bindings_.size());
+			for (size_t i = 0; i < layout.bindings_.size(); ++i)
+			{
+				const VkDescriptorSetLayoutBinding& binding =
+				    layout.bindings_[i];
+
+				// Samplers are objects of this run
+				if (binding.pImmutableSamplers)
+				{
+					return std::nullopt;
+				}
+
+				state << binding.binding << binding.descriptorType
+				      << binding.descriptorCount << binding.stageFlags
+				      << layout.flags_[i];
+			}
+		}
+
+		state << static_cast<uint32_t>(builder.pushConstants_.size());
+		for (const VkPushConstantRange& range : builder.pushConstants_)
+		{
+			state << range.stageFlags << range.offset << range.size;
+		}
+
+		return std::move(state).str();
+	}
+
+	std::optional<PipelineBuilder> PipelineManifest::deserialize(
+	    std::string_view bytes) const
+	{
+		try
+		{
+			Reader state(bytes);
+
+			std::string_view name           = state.string();
+			std::string_view renderPassName = state.string();
+			uint32_t subpass                = state.read<uint32_t>();
+
+			std::vector<VkFormat> colorFormats(state.read<uint32_t>());
+			for (VkFormat& format : colorFormats)
+			{
+				format = state.read<VkFormat>();
+			}
+
+			auto depthFormat = state.read<VkFormat>();
+
+			std::optional<PipelineBuilder> created;
+
+			if (renderPassName.empty())
+			{
+				created.emplace(device_, colorFormats, depthFormat);
+			}
+			else
+			{
+				auto renderPass =
+				    renderPasses_.find(std::string(renderPassName));
+				if (renderPass == renderPasses_.end())
+				{
+					return std::nullopt;
+				}
+
+				created.emplace(device_, renderPass->second);
+			}
+
+			PipelineBuilder& builder = *created;
+			builder.name(std::string(name));
+			builder.subpass(subpass);
+
+			uint32_t stageCount = state.read<uint32_t>();
+			for (uint32_t i = 0; i < stageCount; ++i)
+			{
+				auto stage = state.read<VkShaderStageFlagBits>();
+
+				auto shader = shaders_.find(std::string(state.string()));
+				if (shader == shaders_.end())
+				{
+					return std::nullopt;
+				}
+
+				// Builders keep a pointer to the entrypoint
+				const char* pEntrypoint =
+				    entrypoints_.emplace(state.string()).first->c_str();
+
+				Specialization specialization;
+
+				uint32_t entryCount = state.read<uint32_t>();
+				for (uint32_t j = 0; j < entryCount; ++j)
+				{
+					VkSpecializationMapEntry entry{};
+					entry.constantID = state.read<uint32_t>();
+					entry.offset     = state.read<uint32_t>();
+					entry.size       = state.read<uint32_t>();
+
+					specialization.entries_.push_back(entry);
+				}
+
+				std::string_view data = state.string();
+				specialization.data_.assign(data.begin(), data.end());
+
+				for (const VkSpecializationMapEntry& entry :
+				     specialization.entries_)
+				{
+					uint64_t end =
+					    static_cast<uint64_t>(entry.offset) + entry.size;
+
+					// The driver would read past the data otherwise
+					if (end > data.size())
+					{
+						return std::nullopt;
+					}
+				}
+
+				builder.addStage(
+				    stage, shader->second, pEntrypoint, specialization);
+			}
+
+			VertexDescription& description = builder.description_;
+
+			uint32_t bindingCount = state.read<uint32_t>();
+			for (uint32_t i = 0; i < bindingCount; ++i)
+			{
+				VkVertexInputBindingDescription binding{};
+				binding.binding   = state.read<uint32_t>();
+				binding.stride    = state.read<uint32_t>();
+				binding.inputRate = state.read<VkVertexInputRate>();
+
+				description.bindings_.push_back(binding);
+			}
+
+			uint32_t attributeCount = state.read<uint32_t>();
+			for (uint32_t i = 0; i < attributeCount; ++i)
+			{
+				VkVertexInputAttributeDescription attribute{};
+				attribute.location = state.read<uint32_t>();
+				attribute.binding  = state.read<uint32_t>();
+				attribute.format   = state.read<VkFormat>();
+				attribute.offset   = state.read<uint32_t>();
+
+				description.attributes_.push_back(attribute);
+			}
+
+			builder.topology(state.read<VkPrimitiveTopology>());
+			builder.polygonMode(state.read<VkPolygonMode>());
+			builder.cullMode(state.read<VkCullModeFlags>());
+			builder.frontFace(state.read<VkFrontFace>());
+			builder.samples(state.read<VkSampleCountFlagBits>());
+
+			bool depthTest      = state.flag();
+			bool depthWrite     = state.flag();
+			auto depthCompareOp = state.read<VkCompareOp>();
+
+			if (depthTest)
+			{
+				builder.depthTest(depthCompareOp, depthWrite);
+			}
+
+			uint32_t dynamicCount = state.read<uint32_t>();
+			for (uint32_t i = 0; i < dynamicCount; ++i)
+			{
+				builder.addDynamicState(state.read<VkDynamicState>());
+			}
+
+			uint32_t layoutCount = state.read<uint32_t>();
+			for (uint32_t i = 0; i < layoutCount; ++i)
+			{
+				DescriptorLayout layout;
+
+				uint32_t count = state.read<uint32_t>();
+				for (uint32_t j = 0; j < count; ++j)
+				{
+					VkDescriptorSetLayoutBinding binding{};
+					binding.binding         = state.read<uint32_t>();
+					binding.descriptorType  = state.read<VkDescriptorType>();
+					binding.descriptorCount = state.read<uint32_t>();
+					binding.stageFlags      = state.read<VkShaderStageFlags>();
+
+					layout.bindings_.push_back(binding);
+					layout.flags_.push_back(
+					    state.read<VkDescriptorBindingFlags>());
+				}
+
+				builder.descriptorLayout(layout, i);
+			}
+
+			uint32_t rangeCount = state.read<uint32_t>();
+			for (uint32_t i = 0; i < rangeCount; ++i)
+			{
+				VkPushConstantRange range{};
+				range.stageFlags = state.read<VkShaderStageFlags>();
+				range.offset     = state.read<uint32_t>();
+				range.size       = state.read<uint32_t>();
+
+				builder.pushConstantRange(
+				    range.stageFlags, range.size, range.offset);
+			}
+
+			if (!state.done())
+			{
+				return std::nullopt;
+			}
+
+			return created;
+		}
+		catch (const std::runtime_error&)
+		{
+			// States from an older layout of the builder are skipped
+			return std::nullopt;
+		}
+	}
+} // namespace sat
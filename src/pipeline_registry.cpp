@@ -0,0 +1,68 @@
+#include "pipeline_registry.hpp"
+
+#include "pipeline_manifest.hpp"
+
+namespace sat
+{
+	///////////////////////////
+	//// Pipeline Registry ////
+	///////////////////////////
+
+	rn<Pipeline> PipelineRegistry::get(const PipelineBuilder& builder)
+	{
+		std::string key = builder.key();
+
+		{
+			std::lock_guard lock(mutex_);
+
+			auto it = pipelines_.find(key);
+			if (it != pipelines_.end())
+			{
+				return it->second;
+			}
+		}
+
+		// Build without holding the lock so other states compile in parallel
+		rn<Pipeline> pipeline = builder.build();
+
+		std::lock_guard lock(mutex_);
+
+		// If another thread built the same state first, keep its pipeline
+		auto [it, inserted] =
+		    pipelines_.try_emplace(std::move(key), std::move(pipeline));
+
+		if (inserted && pManifest_)
+		{
+			pManifest_->record(builder);
+		}
+
+		return it->second;
+	}
+
+	void PipelineRegistry::prune()
+	{
+		std::lock_guard lock(mutex_);
+
+		std::erase_if(pipelines_, [](const auto& entry) {
+			return entry.second.useCount() == 1;
+		});
+	}
+
+	void PipelineRegistry::clear()
+	{
+		std::lock_guard lock(mutex_);
+		pipelines_.clear();
+	}
+
+	void PipelineRegistry::record(PipelineManifest* pManifest) noexcept
+	{
+		std::lock_guard lock(mutex_);
+		pManifest_ = pManifest;
+	}
+
+	size_t PipelineRegistry::size() const
+	{
+		std::lock_guard lock(mutex_);
+		return pipelines_.size();
+	}
+} // namespace sat
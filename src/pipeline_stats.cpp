@@ -0,0 +1,112 @@
+#include "pipeline_stats.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace sat
+{
+	namespace
+	{
+		const char* stage_name(VkShaderStageFlagBits stage) noexcept
+		{
+			switch (stage)
+			{
+			case VK_SHADER_STAGE_VERTEX_BIT:
+				return "vert";
+			case VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT:
+				return "tesc";
+			case VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT:
+				return "tese";
+			case VK_SHADER_STAGE_GEOMETRY_BIT:
+				return "geom";
+			case VK_SHADER_STAGE_FRAGMENT_BIT:
+				return "frag";
+			case VK_SHADER_STAGE_COMPUTE_BIT:
+				return "comp";
+			default:
+				return "other";
+			}
+		}
+
+		const char* hit_name(const std::optional<bool>& cacheHit) noexcept
+		{
+			if (!cacheHit)
+			{
+				return "?";
+			}
+
+			return *cacheHit ? "hit" : "miss";
+		}
+
+		double milliseconds(uint64_t nanoseconds) noexcept
+		{
+			return nanoseconds / 1e6;
+		}
+	} // namespace
+
+	////////////////////////
+	//// Pipeline Stats ////
+	////////////////////////
+
+	void PipelineStats::record(PipelineFeedback feedback)
+	{
+		std::lock_guard lock(mutex_);
+		feedback_.push_back(std::move(feedback));
+	}
+
+	std::vector<PipelineFeedback> PipelineStats::feedback() const
+	{
+		std::lock_guard lock(mutex_);
+		return feedback_;
+	}
+
+	size_t PipelineStats::size() const
+	{
+		std::lock_guard lock(mutex_);
+		return feedback_.size();
+	}
+
+	void PipelineStats::clear() noexcept
+	{
+		std::lock_guard lock(mutex_);
+		feedback_.clear();
+	}
+
+	void PipelineStats::dump(std::ostream& out) const
+	{
+		std::vector<PipelineFeedback> sorted = feedback();
+
+		std::ranges::sort(sorted, std::ranges::greater{},
+		                  &PipelineFeedback::duration);
+
+		uint64_t total = 0;
+		size_t hits    = 0;
+
+		for (const PipelineFeedback& feedback : sorted)
+		{
+			total += feedback.duration;
+			hits += feedback.cacheHit.value_or(false);
+
+			out << std::fixed << std::setprecision(3) << std::setw(10)
+			    << milliseconds(feedback.duration) << " ms  " << std::setw(4)
+			    << hit_name(feedback.cacheHit) << "  "
+			    << (feedback.bindPoint == VK_PIPELINE_BIND_POINT_COMPUTE
+			            ? "compute"
+			            : "graphics")
+			    << "  " << (feedback.name.empty() ? "-" : feedback.name);
+
+			for (const PipelineFeedback::Stage& stage : feedback.stages)
+			{
+				out << "  " << stage_name(stage.stage) << ' '
+				    << milliseconds(stage.duration) << " ms "
+				    << hit_name(stage.cacheHit);
+			}
+
+			out << '\n';
+		}
+
+		out << sorted.size() << " pipelines, " << hits << " cache hits, "
+		    << std::fixed << std::setprecision(3) << milliseconds(total)
+		    << " ms total\n";
+	}
+} // namespace sat
@@ -0,0 +1,834 @@
+#include "reflection.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+
+namespace sat
+{
+	namespace
+	{
+		constexpr uint32_t spirv_magic = 0x07230203;
+
+		/**
+		 * \brief The few SPIR-V enumerants that the reflector reads.
+		 */
+		enum Op : uint32_t
+		{
+			OpEntryPoint                = 15,
+			OpExecutionMode             = 16,
+			OpTypeBool                  = 20,
+			OpTypeInt                   = 21,
+			OpTypeFloat                 = 22,
+			OpTypeVector                = 23,
+			OpTypeMatrix                = 24,
+			OpTypeImage                 = 25,
+			OpTypeSampler               = 26,
+			OpTypeSampledImage          = 27,
+			OpTypeArray                 = 28,
+			OpTypeRuntimeArray          = 29,
+			OpTypeStruct                = 30,
+			OpTypePointer               = 32,
+			OpConstant                  = 43,
+			OpConstantComposite         = 44,
+			OpSpecConstant              = 50,
+			OpSpecConstantComposite     = 51,
+			OpSpecConstantOp            = 52,
+			OpVariable                  = 59,
+			OpDecorate                  = 71,
+			OpMemberDecorate            = 72,
+			OpExecutionModeId           = 331,
+			OpTypeAccelerationStructure = 5341,
+		};
+
+		/**
+		 * \brief Integer operations that specialization constant expressions
+		 * can use, such as in the size of an array.
+		 */
+		enum SpecOp : uint32_t
+		{
+			OpSNegate              = 126,
+			OpIAdd                 = 128,
+			OpISub                 = 130,
+			OpIMul                 = 132,
+			OpUDiv                 = 134,
+			OpSDiv                 = 135,
+			OpUMod                 = 137,
+			OpSRem                 = 138,
+			OpSMod                 = 139,
+			OpShiftRightLogical    = 194,
+			OpShiftRightArithmetic = 195,
+			OpShiftLeftLogical     = 196,
+			OpBitwiseOr            = 197,
+			OpBitwiseXor           = 198,
+			OpBitwiseAnd           = 199,
+			OpNot                  = 200,
+		};
+
+		enum Decoration : uint32_t
+		{
+			DecorationBlock         = 2,
+			DecorationBufferBlock   = 3,
+			DecorationArrayStride   = 6,
+			DecorationMatrixStride  = 7,
+			DecorationBuiltIn       = 11,
+			DecorationLocation      = 30,
+			DecorationBinding       = 33,
+			DecorationDescriptorSet = 34,
+			DecorationOffset        = 35,
+		};
+
+		enum StorageClass : uint32_t
+		{
+			StorageClassUniformConstant = 0,
+			StorageClassInput           = 1,
+			StorageClassUniform         = 2,
+			StorageClassPushConstant    = 9,
+			StorageClassStorageBuffer   = 12,
+		};
+
+		constexpr uint32_t execution_mode_local_size    = 17;
+		constexpr uint32_t execution_mode_local_size_id = 38;
+		constexpr uint32_t built_in_workgroup_size      = 25;
+		constexpr uint32_t dim_buffer                   = 5;
+		constexpr uint32_t dim_subpass_data             = 6;
+
+		struct Decorations
+		{
+			std::optional<uint32_t> set;
+			std::optional<uint32_t> binding;
+			std::optional<uint32_t> location;
+			std::optional<uint32_t> arrayStride;
+			std::optional<uint32_t> matrixStride;
+			std::optional<uint32_t> offset;
+			std::optional<uint32_t> builtIn;
+			bool block       = false;
+			bool bufferBlock = false;
+		};
+
+		/**
+		 * \brief Instruction that declares a type, without its result id.
+		 */
+		struct Type
+		{
+			uint32_t opcode;
+			std::vector<uint32_t> operands;
+		};
+
+		struct Variable
+		{
+			uint32_t id;
+			uint32_t pointerType;
+			uint32_t storageClass;
+		};
+
+		class Reflector
+		{
+		public:
+			explicit Reflector(std::span<uint32_t const> code);
+
+			ShaderReflection reflect() const;
+
+		private:
+			const Type& type(uint32_t id) const;
+			uint32_t constant(uint32_t id) const;
+			uint32_t evaluate(std::span<uint32_t const> operation) const;
+			const Decorations& decorations(uint32_t id) const;
+			const Decorations& member(uint32_t id, uint32_t index) const;
+
+			uint32_t size(uint32_t typeId,
+			              std::optional<uint32_t> matrixStride = {}) const;
+			bool builtIn(uint32_t typeId) const;
+
+			void addInputs(ShaderReflection& reflection,
+			               const Variable& variable) const;
+			void addBinding(ShaderReflection& reflection,
+			                const Variable& variable) const;
+
+			VkShaderStageFlagBits stage_ = VK_SHADER_STAGE_ALL;
+			std::array<uint32_t, 3> workgroupSize_ = {1, 1, 1};
+			std::optional<std::array<uint32_t, 3>> workgroupSizeIds_;
+			std::unordered_map<uint32_t, Type> types_;
+			std::unordered_map<uint32_t, uint32_t> constants_;
+			std::unordered_map<uint32_t, std::vector<uint32_t>> specOps_;
+			std::unordered_map<uint32_t, std::vector<uint32_t>> composites_;
+			std::unordered_map<uint32_t, Decorations> decorations_;
+			std::unordered_map<uint32_t, std::vector<Decorations>> members_;
+			std::vector<Variable> variables_;
+		};
+
+		VkShaderStageFlagBits stage_of(uint32_t executionModel) noexcept
+		{
+			switch (executionModel)
+			{
+			case 0:
+				return VK_SHADER_STAGE_VERTEX_BIT;
+			case 1:
+				return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+			case 2:
+				return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+			case 3:
+				return VK_SHADER_STAGE_GEOMETRY_BIT;
+			case 4:
+				return VK_SHADER_STAGE_FRAGMENT_BIT;
+			case 5:
+				return VK_SHADER_STAGE_COMPUTE_BIT;
+			default:
+				return VK_SHADER_STAGE_ALL;
+			}
+		}
+
+		VkFormat input_format(uint32_t opcode,
+		                      uint32_t width,
+		                      bool isSigned,
+		                      uint32_t components) noexcept
+		{
+			static constexpr VkFormat float16[] = {
+			    VK_FORMAT_R16_SFLOAT,
+			    VK_FORMAT_R16G16_SFLOAT,
+			    VK_FORMAT_R16G16B16_SFLOAT,
+			    VK_FORMAT_R16G16B16A16_SFLOAT};
+			static constexpr VkFormat float32[] = {
+			    VK_FORMAT_R32_SFLOAT,
+			    VK_FORMAT_R32G32_SFLOAT,
+			    VK_FORMAT_R32G32B32_SFLOAT,
+			    VK_FORMAT_R32G32B32A32_SFLOAT};
+			static constexpr VkFormat float64[] = {
+			    VK_FORMAT_R64_SFLOAT,
+			    VK_FORMAT_R64G64_SFLOAT,
+			    VK_FORMAT_R64G64B64_SFLOAT,
+			    VK_FORMAT_R64G64B64A64_SFLOAT};
+			static constexpr VkFormat sint32[] = {
+			    VK_FORMAT_R32_SINT,
+			    VK_FORMAT_R32G32_SINT,
+			    VK_FORMAT_R32G32B32_SINT,
+			    VK_FORMAT_R32G32B32A32_SINT};
+			static constexpr VkFormat uint32[] = {
+			    VK_FORMAT_R32_UINT,
+			    VK_FORMAT_R32G32_UINT,
+			    VK_FORMAT_R32G32B32_UINT,
+			    VK_FORMAT_R32G32B32A32_UINT};
+
+			if (components < 1 || components > 4)
+			{
+				return VK_FORMAT_UNDEFINED;
+			}
+
+			if (opcode == OpTypeFloat)
+			{
+				switch (width)
+				{
+				case 16:
+					return float16[components - 1];
+				case 32:
+					return float32[components - 1];
+				case 64:
+					return float64[components - 1];
+				}
+			}
+			else if (opcode == OpTypeInt && width == 32)
+			{
+				return isSigned ? sint32[components - 1]
+				                : uint32[components - 1];
+			}
+
+			return VK_FORMAT_UNDEFINED;
+		}
+
+		Reflector::Reflector(std::span<uint32_t const> code)
+		{
+			if (code.size() < 5 || code[0] != spirv_magic)
+			{
+				throw std::runtime_error("Invalid SPIR-V header");
+			}
+
+			for (size_t i = 5; i < code.size();)
+			{
+				uint32_t wordCount = code[i] >> 16;
+				uint32_t opcode    = code[i] & 0xFFFF;
+
+				if (wordCount == 0 || i + wordCount > code.size())
+				{
+					throw std::runtime_error("Malformed SPIR-V instruction");
+				}
+
+				std::span<uint32_t const> operands =
+				    code.subspan(i + 1, wordCount - 1);
+				i += wordCount;
+
+				switch (opcode)
+				{
+				case OpEntryPoint:
+					if (stage_ == VK_SHADER_STAGE_ALL && !operands.empty())
+					{
+						stage_ = stage_of(operands[0]);
+					}
+					break;
+
+				case OpExecutionMode:
+				case OpExecutionModeId:
+					if (operands.size() == 5 &&
+					    (operands[1] == execution_mode_local_size ||
+					     operands[1] == execution_mode_local_size_id))
+					{
+						std::array<uint32_t, 3> size = {
+						    operands[2], operands[3], operands[4]};
+
+						if (operands[1] == execution_mode_local_size)
+						{
+							workgroupSize_ = size;
+						}
+						else
+						{
+							workgroupSizeIds_ = size;
+						}
+					}
+					break;
+
+				case OpTypeBool:
+				case OpTypeInt:
+				case OpTypeFloat:
+				case OpTypeVector:
+				case OpTypeMatrix:
+				case OpTypeImage:
+				case OpTypeSampler:
+				case OpTypeSampledImage:
+				case OpTypeArray:
+				case OpTypeRuntimeArray:
+				case OpTypeStruct:
+				case OpTypePointer:
+				case OpTypeAccelerationStructure:
+					if (!operands.empty())
+					{
+						types_[operands[0]] = {
+						    opcode, {operands.begin() + 1, operands.end()}};
+					}
+					break;
+
+				case OpConstant:
+				case OpSpecConstant:
+					if (operands.size() >= 3)
+					{
+						constants_[operands[1]] = operands[2];
+					}
+					break;
+
+				case OpSpecConstantOp:
+					if (operands.size() >= 3)
+					{
+						specOps_[operands[1]] = {operands.begin() + 2,
+						                         operands.end()};
+					}
+					break;
+
+				case OpConstantComposite:
+				case OpSpecConstantComposite:
+					if (operands.size() >= 2)
+					{
+						composites_[operands[1]] = {operands.begin() + 2,
+						                            operands.end()};
+					}
+					break;
+
+				case OpVariable:
+					if (operands.size() >= 3)
+					{
+						variables_.push_back(
+						    {operands[1], operands[0], operands[2]});
+					}
+					break;
+
+				case OpDecorate:
+				case OpMemberDecorate:
+				{
+					bool isMember = opcode == OpMemberDecorate;
+
+					if (operands.size() < (isMember ? 3u : 2u))
+					{
+						break;
+					}
+
+					Decorations* pTarget = &decorations_[operands[0]];
+
+					if (isMember)
+					{
+						std::vector<Decorations>& members =
+						    members_[operands[0]];
+
+						if (members.size() <= operands[1])
+						{
+							members.resize(operands[1] + 1);
+						}
+
+						pTarget  = &members[operands[1]];
+						operands = operands.subspan(1);
+					}
+
+					std::optional<uint32_t> value;
+					if (operands.size() >= 3)
+					{
+						value = operands[2];
+					}
+
+					switch (operands[1])
+					{
+					case DecorationBlock:
+						pTarget->block = true;
+						break;
+					case DecorationBufferBlock:
+						pTarget->bufferBlock = true;
+						break;
+					case DecorationArrayStride:
+						pTarget->arrayStride = value;
+						break;
+					case DecorationMatrixStride:
+						pTarget->matrixStride = value;
+						break;
+					case DecorationBuiltIn:
+						pTarget->builtIn = value;
+						break;
+					case DecorationLocation:
+						pTarget->location = value;
+						break;
+					case DecorationBinding:
+						pTarget->binding = value;
+						break;
+					case DecorationDescriptorSet:
+						pTarget->set = value;
+						break;
+					case DecorationOffset:
+						pTarget->offset = value;
+						break;
+					}
+					break;
+				}
+				}
+			}
+		}
+
+		ShaderReflection Reflector::reflect() const
+		{
+			ShaderReflection reflection;
+			reflection.stage         = stage_;
+			reflection.workgroupSize = workgroupSize_;
+
+			if (workgroupSizeIds_)
+			{
+				for (size_t i = 0; i < 3; ++i)
+				{
+					reflection.workgroupSize[i] =
+					    constant((*workgroupSizeIds_)[i]);
+				}
+			}
+
+			// A constant decorated as the WorkgroupSize builtin overrides
+			// the execution mode
+			for (const auto& [id, components] : composites_)
+			{
+				if (decorations(id).builtIn != built_in_workgroup_size ||
+				    components.size() != 3)
+				{
+					continue;
+				}
+
+				for (size_t i = 0; i < 3; ++i)
+				{
+					reflection.workgroupSize[i] = constant(components[i]);
+				}
+			}
+
+			for (const Variable& variable : variables_)
+			{
+				switch (variable.storageClass)
+				{
+				case StorageClassInput:
+					addInputs(reflection, variable);
+					break;
+
+				case StorageClassUniformConstant:
+				case StorageClassUniform:
+				case StorageClassStorageBuffer:
+					addBinding(reflection, variable);
+					break;
+
+				case StorageClassPushConstant:
+				{
+					const Type& pointer = type(variable.pointerType);
+					reflection.pushConstantSize =
+					    std::max(reflection.pushConstantSize,
+					             size(pointer.operands.at(1)));
+					break;
+				}
+				}
+			}
+
+			std::ranges::sort(reflection.inputs,
+			                  {},
+			                  &ShaderReflection::Input::location);
+			std::ranges::sort(reflection.bindings,
+			                  [](const ShaderReflection::Binding& a,
+			                     const ShaderReflection::Binding& b) {
+				                  return std::tie(a.set, a.binding) <
+				                         std::tie(b.set, b.binding);
+			                  });
+
+			return reflection;
+		}
+
+		const Type& Reflector::type(uint32_t id) const
+		{
+			auto it = types_.find(id);
+			if (it == types_.end())
+			{
+				throw std::runtime_error("SPIR-V refers to an unknown type");
+			}
+
+			return it->second;
+		}
+
+		uint32_t Reflector::constant(uint32_t id) const
+		{
+			auto it = constants_.find(id);
+			if (it != constants_.end())
+			{
+				return it->second;
+			}
+
+			// Expressions are evaluated with the default values
+			auto op = specOps_.find(id);
+			if (op != specOps_.end())
+			{
+				return evaluate(op->second);
+			}
+
+			throw std::runtime_error("SPIR-V refers to an unknown constant");
+		}
+
+		uint32_t Reflector::evaluate(std::span<uint32_t const> operation) const
+		{
+			if (operation.size() < 2)
+			{
+				throw std::runtime_error("Malformed SPIR-V instruction");
+			}
+
+			uint32_t a = constant(operation[1]);
+
+			switch (operation[0])
+			{
+			case OpSNegate:
+				return -a;
+			case OpNot:
+				return ~a;
+			}
+
+			if (operation.size() < 3)
+			{
+				throw std::runtime_error("Malformed SPIR-V instruction");
+			}
+
+			uint32_t b = constant(operation[2]);
+
+			auto sa = static_cast<int32_t>(a);
+			auto sb = static_cast<int32_t>(b);
+
+			switch (operation[0])
+			{
+			case OpIAdd:
+				return a + b;
+			case OpISub:
+				return a - b;
+			case OpIMul:
+				return a * b;
+			case OpShiftRightLogical:
+				return a >> (b & 31);
+			case OpShiftRightArithmetic:
+				return static_cast<uint32_t>(sa >> (b & 31));
+			case OpShiftLeftLogical:
+				return a << (b & 31);
+			case OpBitwiseOr:
+				return a | b;
+			case OpBitwiseXor:
+				return a ^ b;
+			case OpBitwiseAnd:
+				return a & b;
+			}
+
+			if (b == 0)
+			{
+				throw std::runtime_error(
+				    "SPIR-V constant expression divides by zero");
+			}
+
+			switch (operation[0])
+			{
+			case OpUDiv:
+				return a / b;
+			case OpSDiv:
+				return static_cast<uint32_t>(sa / sb);
+			case OpUMod:
+				return a % b;
+			case OpSRem:
+				return static_cast<uint32_t>(sa % sb);
+			case OpSMod:
+			{
+				int32_t r = sa % sb;
+				return static_cast<uint32_t>(r != 0 && (r < 0) != (sb < 0)
+				                                 ? r + sb
+				                                 : r);
+			}
+			}
+
+			throw std::runtime_error(
+			    "SPIR-V constant uses an unsupported operation");
+		}
+
+		const Decorations& Reflector::decorations(uint32_t id) const
+		{
+			static const Decorations none;
+
+			auto it = decorations_.find(id);
+			return it == decorations_.end() ? none : it->second;
+		}
+
+		const Decorations& Reflector::member(uint32_t id,
+		                                     uint32_t index) const
+		{
+			static const Decorations none;
+
+			auto it = members_.find(id);
+			if (it == members_.end() || it->second.size() <= index)
+			{
+				return none;
+			}
+
+			return it->second[index];
+		}
+
+		uint32_t Reflector::size(uint32_t typeId,
+		                         std::optional<uint32_t> matrixStride) const
+		{
+			const Type& t = type(typeId);
+
+			switch (t.opcode)
+			{
+			case OpTypeBool:
+				return 4;
+
+			case OpTypeInt:
+			case OpTypeFloat:
+				return t.operands.at(0) / 8;
+
+			case OpTypeVector:
+				return t.operands.at(1) * size(t.operands.at(0));
+
+			case OpTypeMatrix:
+				return t.operands.at(1) *
+				       matrixStride.value_or(size(t.operands.at(0)));
+
+			case OpTypeArray:
+			{
+				uint32_t stride =
+				    decorations(typeId).arrayStride.value_or(
+				        size(t.operands.at(0), matrixStride));
+				return constant(t.operands.at(1)) * stride;
+			}
+
+			case OpTypeRuntimeArray:
+				return 0;
+
+			case OpTypeStruct:
+			{
+				uint32_t end = 0;
+
+				for (uint32_t i = 0; i < t.operands.size(); ++i)
+				{
+					const Decorations& decorations = member(typeId, i);
+
+					uint32_t offset = decorations.offset.value_or(end);
+					uint32_t bytes =
+					    size(t.operands[i], decorations.matrixStride);
+
+					end = std::max(end, offset + bytes);
+				}
+
+				return end;
+			}
+
+			case OpTypePointer:
+				return 8;
+
+			default:
+				return 0;
+			}
+		}
+
+		bool Reflector::builtIn(uint32_t typeId) const
+		{
+			const Type& t = type(typeId);
+
+			if (t.opcode == OpTypeArray || t.opcode == OpTypeRuntimeArray)
+			{
+				return builtIn(t.operands.at(0));
+			}
+
+			return t.opcode == OpTypeStruct &&
+			       member(typeId, 0).builtIn.has_value();
+		}
+
+		void Reflector::addInputs(ShaderReflection& reflection,
+		                          const Variable& variable) const
+		{
+			const Decorations& decorated = decorations(variable.id);
+			uint32_t typeId = type(variable.pointerType).operands.at(1);
+
+			if (decorated.builtIn || !decorated.location || builtIn(typeId))
+			{
+				return;
+			}
+
+			uint32_t locations = 1;
+			const Type* pType  = &type(typeId);
+
+			while (pType->opcode == OpTypeArray)
+			{
+				locations *= constant(pType->operands.at(1));
+				pType = &type(pType->operands.at(0));
+			}
+
+			if (pType->opcode == OpTypeMatrix)
+			{
+				locations *= pType->operands.at(1);
+				pType = &type(pType->operands.at(0));
+			}
+
+			uint32_t components = 1;
+
+			if (pType->opcode == OpTypeVector)
+			{
+				components = pType->operands.at(1);
+				pType      = &type(pType->operands.at(0));
+			}
+
+			uint32_t width = pType->operands.empty() ? 32 : pType->operands[0];
+			bool isSigned =
+			    pType->operands.size() > 1 && pType->operands[1] != 0;
+
+			ShaderReflection::Input input{};
+			input.format =
+			    input_format(pType->opcode, width, isSigned, components);
+			input.size = components * width / 8;
+
+			for (uint32_t i = 0; i < locations; ++i)
+			{
+				input.location = *decorated.location + i;
+				reflection.inputs.push_back(input);
+			}
+		}
+
+		void Reflector::addBinding(ShaderReflection& reflection,
+		                           const Variable& variable) const
+		{
+			const Decorations& decorated = decorations(variable.id);
+
+			if (!decorated.binding)
+			{
+				return;
+			}
+
+			ShaderReflection::Binding binding{};
+			binding.set     = decorated.set.value_or(0);
+			binding.binding = *decorated.binding;
+			binding.count   = 1;
+
+			uint32_t typeId = type(variable.pointerType).operands.at(1);
+
+			for (const Type* pType = &type(typeId);; pType = &type(typeId))
+			{
+				if (pType->opcode == OpTypeArray)
+				{
+					binding.count *= constant(pType->operands.at(1));
+				}
+				else if (pType->opcode == OpTypeRuntimeArray)
+				{
+					binding.count = 0;
+				}
+				else
+				{
+					break;
+				}
+
+				typeId = pType->operands.at(0);
+			}
+
+			const Type& t = type(typeId);
+
+			switch (t.opcode)
+			{
+			case OpTypeSampler:
+				binding.type = VK_DESCRIPTOR_TYPE_SAMPLER;
+				break;
+
+			case OpTypeSampledImage:
+				binding.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+				break;
+
+			case OpTypeImage:
+			{
+				uint32_t dim     = t.operands.at(1);
+				uint32_t sampled = t.operands.at(5);
+
+				if (dim == dim_buffer)
+				{
+					binding.type =
+					    sampled == 2
+					        ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER
+					        : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+				}
+				else if (dim == dim_subpass_data)
+				{
+					binding.type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+				}
+				else
+				{
+					binding.type = sampled == 2
+					                   ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE
+					                   : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+				}
+				break;
+			}
+
+			case OpTypeAccelerationStructure:
+				binding.type =
+				    VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+				break;
+
+			case OpTypeStruct:
+			{
+				bool storage =
+				    variable.storageClass == StorageClassStorageBuffer ||
+				    decorations(typeId).bufferBlock;
+
+				binding.type = storage
+				                   ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
+				                   : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+				break;
+			}
+
+			default:
+				return;
+			}
+
+			reflection.bindings.push_back(binding);
+		}
+	} // namespace
+
+	namespace spirv
+	{
+		ShaderReflection reflect(std::span<uint32_t const> code)
+		{
+			return Reflector(code).reflect();
+		}
+	} // namespace spirv
+} // namespace sat
@@ -2,9 +2,34 @@
 
 #include "device.hpp"
 #include "error.hpp"
+#include "framebuffer_cache.hpp"
+#include "image.hpp"
+#include "key.hpp"
 
 namespace sat
 {
+	namespace
+	{
+		/**
+		 * \brief Writes \p count references, or only their absence when
+		 * \p pReferences is null.
+		 */
+		void encode_references(Key& key,
+		                       const VkAttachmentReference* pReferences,
+		                       uint32_t count)
+		{
+			key << (pReferences != nullptr);
+
+			if (pReferences != nullptr)
+			{
+				for (uint32_t i = 0; i < count; ++i)
+				{
+					key << pReferences[i].attachment << pReferences[i].layout;
+				}
+			}
+		}
+	} // namespace
+
 	/////////////////////////////
 	//// Render Pass Builder ////
 	/////////////////////////////
@@ -13,22 +38,66 @@ namespace sat
 	    : device_(std::move(device))
 	{}
 
+	RenderPassBuilder& RenderPassBuilder::createAttachment(
+	    const VkAttachmentDescription& attachment) noexcept
+	{
+		attachments_.push_back(attachment);
+		return *this;
+	}
+
 	RenderPassBuilder& RenderPassBuilder::createColorAttachment(
-	    VkFormat format) noexcept
+	    VkFormat format,
+	    VkAttachmentLoadOp loadOp,
+	    VkAttachmentStoreOp storeOp,
+	    VkImageLayout finalLayout,
+	    VkSampleCountFlagBits samples) noexcept
 	{
 		VkAttachmentDescription attachment{};
 		attachment.format         = format;
-		attachment.samples        = VK_SAMPLE_COUNT_1_BIT;
-		attachment.loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR;
-		attachment.storeOp        = VK_ATTACHMENT_STORE_OP_STORE;
+		attachment.samples        = samples;
+		attachment.loadOp         = loadOp;
+		attachment.storeOp        = storeOp;
 		attachment.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 		attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 		attachment.initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
-		attachment.finalLayout    = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		attachment.finalLayout    = finalLayout;
 
-		attachments_.push_back(attachment);
+		// Loading needs the contents to be in a known layout
+		if (loadOp == VK_ATTACHMENT_LOAD_OP_LOAD)
+		{
+			attachment.initialLayout = finalLayout;
+		}
 
-		return *this;
+		return createAttachment(attachment);
+	}
+
+	RenderPassBuilder& RenderPassBuilder::createDepthAttachment(
+	    VkFormat format,
+	    VkAttachmentLoadOp loadOp,
+	    VkAttachmentStoreOp storeOp,
+	    VkImageLayout finalLayout,
+	    VkSampleCountFlagBits samples) noexcept
+	{
+		bool stencil = image::aspect(format) & VK_IMAGE_ASPECT_STENCIL_BIT;
+
+		VkAttachmentDescription attachment{};
+		attachment.format  = format;
+		attachment.samples = samples;
+		attachment.loadOp  = loadOp;
+		attachment.storeOp = storeOp;
+		attachment.stencilLoadOp =
+		    stencil ? loadOp : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		attachment.stencilStoreOp =
+		    stencil ? storeOp : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		attachment.finalLayout   = finalLayout;
+
+		if (loadOp == VK_ATTACHMENT_LOAD_OP_LOAD)
+		{
+			attachment.initialLayout = finalLayout;
+		}
+
+		return createAttachment(attachment);
 	}
 
 	RenderPassBuilder& RenderPassBuilder::begin(
@@ -45,7 +114,7 @@ namespace sat
 	RenderPassBuilder& RenderPassBuilder::end() noexcept
 	{
 		std::vector<VkAttachmentReference>& references = store_.emplace_back();
-		references.reserve(colorAttachments_.size());
+		references.reserve(colorAttachments_.size() * 2 + 1);
 
 		VkSubpassDescription& desc = subpasses_.back();
 
@@ -55,7 +124,30 @@ namespace sat
 		                  colorAttachments_.begin(),
 		                  colorAttachments_.end());
 
+		// Resolves pair up with color attachments, so unused ones are padded
+		if (!resolveAttachments_.empty())
+		{
+			VkAttachmentReference unused{};
+			unused.attachment = VK_ATTACHMENT_UNUSED;
+
+			resolveAttachments_.resize(colorAttachments_.size(), unused);
+
+			desc.pResolveAttachments = references.data() + references.size();
+			references.insert(references.end(),
+			                  resolveAttachments_.begin(),
+			                  resolveAttachments_.end());
+		}
+
+		if (depthAttachment_)
+		{
+			desc.pDepthStencilAttachment =
+			    references.data() + references.size();
+			references.push_back(*depthAttachment_);
+		}
+
 		colorAttachments_.clear();
+		resolveAttachments_.clear();
+		depthAttachment_.reset();
 
 		return *this;
 	}
@@ -72,6 +164,86 @@ namespace sat
 		return *this;
 	}
 
+	RenderPassBuilder& RenderPassBuilder::addResolveAttachment(
+	    uint32_t index, VkImageLayout layout) noexcept
+	{
+		VkAttachmentReference reference{};
+		reference.attachment = index;
+		reference.layout     = layout;
+
+		resolveAttachments_.push_back(reference);
+
+		return *this;
+	}
+
+	RenderPassBuilder& RenderPassBuilder::depthAttachment(
+	    uint32_t index, VkImageLayout layout) noexcept
+	{
+		VkAttachmentReference reference{};
+		reference.attachment = index;
+		reference.layout     = layout;
+
+		depthAttachment_ = reference;
+
+		return *this;
+	}
+
+	RenderPassBuilder& RenderPassBuilder::addDependency(
+	    const VkSubpassDependency& dependency) noexcept
+	{
+		dependencies_.push_back(dependency);
+		return *this;
+	}
+
+	std::string RenderPassBuilder::key() const
+	{
+		// Render passes can't be shared across devices
+		Key key;
+		key << device_->handle() << static_cast<uint32_t>(attachments_.size());
+
+		for (const VkAttachmentDescription& attachment : attachments_)
+		{
+			key << attachment.flags << attachment.format << attachment.samples
+			    << attachment.loadOp << attachment.storeOp
+			    << attachment.stencilLoadOp << attachment.stencilStoreOp
+			    << attachment.initialLayout << attachment.finalLayout;
+		}
+
+		key << static_cast<uint32_t>(subpasses_.size());
+
+		for (const VkSubpassDescription& subpass : subpasses_)
+		{
+			key << subpass.flags << subpass.pipelineBindPoint
+			    << subpass.inputAttachmentCount << subpass.colorAttachmentCount
+			    << subpass.preserveAttachmentCount;
+
+			encode_references(
+			    key, subpass.pInputAttachments, subpass.inputAttachmentCount);
+			encode_references(
+			    key, subpass.pColorAttachments, subpass.colorAttachmentCount);
+			encode_references(
+			    key, subpass.pResolveAttachments, subpass.colorAttachmentCount);
+			encode_references(key, subpass.pDepthStencilAttachment, 1);
+
+			for (uint32_t i = 0; i < subpass.preserveAttachmentCount; ++i)
+			{
+				key << subpass.pPreserveAttachments[i];
+			}
+		}
+
+		key << static_cast<uint32_t>(dependencies_.size());
+
+		for (const VkSubpassDependency& dependency : dependencies_)
+		{
+			key << dependency.srcSubpass << dependency.dstSubpass
+			    << dependency.srcStageMask << dependency.dstStageMask
+			    << dependency.srcAccessMask << dependency.dstAccessMask
+			    << dependency.dependencyFlags;
+		}
+
+		return std::move(key).str();
+	}
+
 	/////////////////////
 	//// Render Pass ////
 	/////////////////////
@@ -85,6 +257,8 @@ namespace sat
 		createInfo.pSubpasses      = builder.subpasses_.data();
 		createInfo.attachmentCount = builder.attachments_.size();
 		createInfo.pAttachments    = builder.attachments_.data();
+		createInfo.dependencyCount = builder.dependencies_.size();
+		createInfo.pDependencies   = builder.dependencies_.data();
 
 		SATURN_CALL(
 		    vkCreateRenderPass(device_, &createInfo, nullptr, &handle_));
@@ -92,6 +266,8 @@ namespace sat
 
 	RenderPass::~RenderPass() noexcept
 	{
+		device_->framebufferCache().invalidateRenderPass(handle_);
+
 		vkDestroyRenderPass(device_, handle_, nullptr);
 	}
 } // namespace sat
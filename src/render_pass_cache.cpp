@@ -0,0 +1,50 @@
+#include "render_pass_cache.hpp"
+
+namespace sat
+{
+	///////////////////////////
+	//// Render Pass Cache ////
+	///////////////////////////
+
+	rn<RenderPass> RenderPassCache::get(const RenderPassBuilder& builder)
+	{
+		std::lock_guard lock(mutex_);
+
+		auto [it, inserted] = renderPasses_.try_emplace(builder.key());
+		if (inserted)
+		{
+			try
+			{
+				it->second = builder.build();
+			}
+			catch (...)
+			{
+				renderPasses_.erase(it);
+				throw;
+			}
+		}
+
+		return it->second;
+	}
+
+	void RenderPassCache::prune()
+	{
+		std::lock_guard lock(mutex_);
+
+		std::erase_if(renderPasses_, [](const auto& entry) {
+			return entry.second.useCount() == 1;
+		});
+	}
+
+	void RenderPassCache::clear()
+	{
+		std::lock_guard lock(mutex_);
+		renderPasses_.clear();
+	}
+
+	size_t RenderPassCache::size() const
+	{
+		std::lock_guard lock(mutex_);
+		return renderPasses_.size();
+	}
+} // namespace sat
@@ -1,26 +1,193 @@
 #include "shader.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <future>
+#include <vector>
+
+#ifndef _WIN32
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
 
 #include "device.hpp"
 #include "error.hpp"
+#include "thread_pool.hpp"
 
 namespace sat
 {
-	ShaderLoader::ShaderLoader(sat::rn<Device> device) noexcept
-	    : device_(device)
+	namespace
+	{
+		constexpr uint32_t spirv_magic = 0x07230203;
+
+		/**
+		 * \brief Throws unless \p pCode holds a whole number of SPIR-V words
+		 * starting with the magic number.
+		 */
+		void validate_spirv(const uint32_t* pCode, size_t byteSize)
+		{
+			if (byteSize < sizeof(uint32_t) || byteSize % sizeof(uint32_t))
+			{
+				throw std::runtime_error(
+				    "SPIR-V size must be a non-zero multiple of 4 bytes");
+			}
+
+			if (reinterpret_cast<uintptr_t>(pCode) % alignof(uint32_t))
+			{
+				throw std::runtime_error("SPIR-V must be aligned to 4 bytes");
+			}
+
+			if (pCode[0] != spirv_magic)
+			{
+				throw std::runtime_error("Invalid SPIR-V magic number");
+			}
+		}
+
+		/**
+		 * \brief 64-bit FNV-1a over whole words, which SPIR-V always is.
+		 */
+		uint64_t hash_spirv(std::span<uint32_t const> code) noexcept
+		{
+			uint64_t hash = 0xCBF29CE484222325;
+
+			for (uint32_t word : code)
+			{
+				hash ^= word;
+				hash *= 0x100000001B3;
+			}
+
+			return hash;
+		}
+
+		/**
+		 * \brief Second hash, independent of \ref hash_spirv, that tells
+		 * modules apart when their code wasn't kept to compare.
+		 */
+		uint64_t check_spirv(std::span<uint32_t const> code) noexcept
+		{
+			uint64_t hash = code.size();
+
+			for (uint32_t word : code)
+			{
+				hash = (hash ^ word) * 0x9E3779B97F4A7C15;
+				hash ^= hash >> 29;
+			}
+
+			return hash;
+		}
+
+		/**
+		 * \brief Read-only view of a whole file. Mappings are page aligned,
+		 * so they can be passed to Vulkan as words without copying.
+		 */
+		class MappedFile
+		{
+		public:
+			explicit MappedFile(const std::filesystem::path& path);
+			~MappedFile() noexcept;
+
+			MappedFile(const MappedFile&)            = delete;
+			MappedFile& operator=(const MappedFile&) = delete;
+
+			const uint32_t* data() const noexcept { return pData_; }
+
+			size_t size() const noexcept { return size_; }
+
+		private:
+			const uint32_t* pData_ = nullptr;
+			size_t size_           = 0;
+
+#ifdef _WIN32
+			// Read into words, which are aligned like a mapping would be
+			std::vector<uint32_t> words_;
+#endif
+		};
+
+#ifdef _WIN32
+		MappedFile::MappedFile(const std::filesystem::path& path)
+		{
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			if (!file.is_open())
+			{
+				throw std::runtime_error("Failed to load shader from file");
+			}
+
+			size_ = file.tellg();
+			file.seekg(0, std::ios::beg);
+
+			words_.resize((size_ + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+			file.read(reinterpret_cast<char*>(words_.data()), size_);
+
+			pData_ = words_.data();
+		}
+
+		MappedFile::~MappedFile() noexcept = default;
+#else
+		MappedFile::MappedFile(const std::filesystem::path& path)
+		{
+			int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+			if (fd < 0)
+			{
+				throw std::runtime_error("Failed to load shader from file");
+			}
+
+			struct stat info;
+			if (fstat(fd, &info) != 0)
+			{
+				close(fd);
+				throw std::runtime_error("Failed to load shader from file");
+			}
+
+			size_ = info.st_size;
+
+			// Empty files can't be mapped, and fail validation anyway
+			if (size_ > 0)
+			{
+				void* pMapping =
+				    mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+
+				if (pMapping == MAP_FAILED)
+				{
+					close(fd);
+					throw std::runtime_error("Failed to map shader file");
+				}
+
+				pData_ = static_cast<const uint32_t*>(pMapping);
+			}
+
+			// The mapping stays valid after the descriptor is closed
+			close(fd);
+		}
+
+		MappedFile::~MappedFile() noexcept
+		{
+			if (pData_)
+			{
+				munmap(const_cast<uint32_t*>(pData_), size_);
+			}
+		}
+#endif
+	} // namespace
+
+	ShaderLoader::ShaderLoader(sat::rn<Device> device, bool keepCode) noexcept
+	    : device_(device), keepCode_(keepCode)
 	{}
 
 	sat::rn<Shader> ShaderLoader::fromFile(
 	    const std::filesystem::path& path) const
 	{
-		std::ifstream file(path, std::ios::binary);
-		if (!file.is_open())
-		{
-			throw std::runtime_error("Failed to load shader from file");
-		}
+		MappedFile file(path);
+
+		sat::rn<Shader> shader = create(file.data(), file.size());
 
-		return fromStream(std::move(file));
+		std::lock_guard lock(mutex_);
+		paths_.try_emplace(shader->handle(), path);
+
+		return shader;
 	}
 
 	sat::rn<Shader> ShaderLoader::fromStream(std::istream&& stream) const
@@ -29,30 +196,190 @@ namespace sat
 		size_t size = stream.tellg();
 		stream.seekg(0, std::ios::beg);
 
-		std::vector<uint8_t> binary(size);
+		// Read into words so the code is aligned for Vulkan
+		std::vector<uint32_t> binary((size + sizeof(uint32_t) - 1) /
+		                             sizeof(uint32_t));
 		stream.read(reinterpret_cast<char*>(binary.data()), size);
 
-		return fromBytes(binary);
+		return create(binary.data(), size);
 	}
 
 	sat::rn<Shader> ShaderLoader::fromBytes(
 	    std::span<uint8_t const> bytes) const
 	{
-		return sat::rn<Shader>(
-		    new Shader(device_,
-		               reinterpret_cast<const uint32_t*>(bytes.data()),
-		               bytes.size()));
+		if (reinterpret_cast<uintptr_t>(bytes.data()) % alignof(uint32_t))
+		{
+			std::vector<uint32_t> binary((bytes.size() + sizeof(uint32_t) - 1) /
+			                             sizeof(uint32_t));
+			std::memcpy(binary.data(), bytes.data(), bytes.size());
+
+			return create(binary.data(), bytes.size());
+		}
+
+		return create(reinterpret_cast<const uint32_t*>(bytes.data()),
+		              bytes.size());
+	}
+
+	sat::rn<Shader> ShaderLoader::fromBytes(
+	    std::span<uint32_t const> words) const
+	{
+		return create(words.data(), words.size_bytes(), true);
+	}
+
+	std::unordered_map<std::string, sat::rn<Shader>>
+	ShaderLoader::fromDirectory(const std::filesystem::path& directory,
+	                            ThreadPool& pool) const
+	{
+		std::vector<std::filesystem::path> paths;
+
+		for (const std::filesystem::directory_entry& entry :
+		     std::filesystem::recursive_directory_iterator(directory))
+		{
+			if (entry.is_regular_file() && entry.path().extension() == ".spv")
+			{
+				paths.push_back(entry.path());
+			}
+		}
+
+		std::vector<std::future<sat::rn<Shader>>> futures;
+		futures.reserve(paths.size());
+
+		for (const std::filesystem::path& path : paths)
+		{
+			futures.push_back(
+			    pool.submit([this, &path]() { return fromFile(path); }));
+		}
+
+		std::vector<sat::rn<Shader>> loaded = ThreadPool::wait(futures);
+		std::unordered_map<std::string, sat::rn<Shader>> shaders;
+
+		for (size_t i = 0; i < paths.size(); ++i)
+		{
+			shaders.emplace(
+			    paths[i].lexically_relative(directory).generic_string(),
+			    std::move(loaded[i]));
+		}
+
+		return shaders;
+	}
+
+	std::filesystem::path ShaderLoader::path(const Shader& shader) const
+	{
+		std::lock_guard lock(mutex_);
+
+		auto it = paths_.find(shader.handle());
+		return it != paths_.end() ? it->second : std::filesystem::path();
+	}
+
+	void ShaderLoader::prune()
+	{
+		std::lock_guard lock(mutex_);
+
+		std::erase_if(shaders_, [this](const auto& entry) {
+			if (entry.second.shader.useCount() > 1)
+			{
+				return false;
+			}
+
+			paths_.erase(entry.second.shader->handle());
+			return true;
+		});
+	}
+
+	void ShaderLoader::clear()
+	{
+		std::lock_guard lock(mutex_);
+		shaders_.clear();
+		paths_.clear();
+	}
+
+	size_t ShaderLoader::size() const
+	{
+		std::lock_guard lock(mutex_);
+		return shaders_.size();
+	}
+
+	sat::rn<Shader> ShaderLoader::create(const uint32_t* pBinary,
+	                                     size_t byteSize,
+	                                     bool borrow) const
+	{
+		validate_spirv(pBinary, byteSize);
+
+		std::span<uint32_t const> code(pBinary, byteSize / sizeof(uint32_t));
+
+		uint64_t hash  = hash_spirv(code);
+		uint64_t check = check_spirv(code);
+
+		// Equal hashes only share a module when the code matches too, and
+		// modules loaded from words only share one that kept its code
+		auto matches = [&](const Entry& entry) {
+			std::span<uint32_t const> cached = entry.shader->code();
+
+			if (cached.empty())
+			{
+				return entry.check == check && !borrow;
+			}
+
+			return entry.check == check && std::ranges::equal(cached, code);
+		};
+
+		{
+			std::lock_guard lock(mutex_);
+
+			auto it = shaders_.find(hash);
+			if (it != shaders_.end() && matches(it->second))
+			{
+				return it->second.shader;
+			}
+		}
+
+		// Create without holding the lock so other modules load in parallel
+		sat::rn<Shader> shader(new Shader(device_, code, borrow, keepCode_));
+
+		std::lock_guard lock(mutex_);
+
+		// If another thread created the same module first, keep its module
+		auto it = shaders_.try_emplace(hash, Entry{check, shader}).first;
+		if (!matches(it->second))
+		{
+			// Hashes collided or the cached module has no code to offer, so
+			// this module isn't shared
+			return shader;
+		}
+
+		return it->second.shader;
 	}
 
 	Shader::Shader(sat::rn<Device> device,
-	               const uint32_t* pBinary,
-	               size_t byteSize)
+	               std::span<uint32_t const> code,
+	               bool borrow,
+	               bool keep)
 	    : device_(device)
 	{
+		if (borrow)
+		{
+			code_ = code;
+		}
+		else if (keep)
+		{
+			storage_.assign(code.begin(), code.end());
+			code_ = storage_;
+		}
+
+		try
+		{
+			reflection_ = spirv::reflect(code);
+		}
+		catch (const std::exception&)
+		{
+			// Only reflecting builders need it, so report it to them
+			reflectionError_ = std::current_exception();
+		}
+
 		VkShaderModuleCreateInfo createInfo{};
 		createInfo.sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-		createInfo.codeSize = byteSize;
-		createInfo.pCode    = pBinary;
+		createInfo.codeSize = code.size_bytes();
+		createInfo.pCode    = code.data();
 
 		SATURN_CALL(
 		    vkCreateShaderModule(device_, &createInfo, nullptr, &handle_));
@@ -62,4 +389,14 @@ namespace sat
 	{
 		vkDestroyShaderModule(device_, handle_, nullptr);
 	}
+
+	const ShaderReflection& Shader::reflection() const
+	{
+		if (reflectionError_)
+		{
+			std::rethrow_exception(reflectionError_);
+		}
+
+		return reflection_;
+	}
 } // namespace sat
@@ -0,0 +1,205 @@
+#include "shader_object.hpp"
+
+#include <stdexcept>
+
+#include "device.hpp"
+#include "error.hpp"
+#include "layouts.hpp"
+#include "shader.hpp"
+
+namespace sat
+{
+	namespace
+	{
+		/**
+		 * \brief Every stage the device supports that may follow \p stage.
+		 */
+		VkShaderStageFlags next_stages(const PhysicalDevice& device,
+		                               VkShaderStageFlagBits stage) noexcept
+		{
+			VkShaderStageFlags tessellation = 0;
+			VkShaderStageFlags geometry     = 0;
+
+			if (device.features.tessellationShader)
+			{
+				tessellation = VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+			}
+
+			if (device.features.geometryShader)
+			{
+				geometry = VK_SHADER_STAGE_GEOMETRY_BIT;
+			}
+
+			switch (stage)
+			{
+			case VK_SHADER_STAGE_VERTEX_BIT:
+				return tessellation | geometry | VK_SHADER_STAGE_FRAGMENT_BIT;
+			case VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT:
+				return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+			case VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT:
+				return geometry | VK_SHADER_STAGE_FRAGMENT_BIT;
+			case VK_SHADER_STAGE_GEOMETRY_BIT:
+				return VK_SHADER_STAGE_FRAGMENT_BIT;
+			default:
+				return 0;
+			}
+		}
+	} // namespace
+
+	///////////////////////////////
+	//// Shader Object Builder ////
+	///////////////////////////////
+
+	ShaderObjectBuilder::ShaderObjectBuilder(rn<Device> device) noexcept
+	    : device_(std::move(device))
+	{}
+
+	ShaderObjectBuilder& ShaderObjectBuilder::addStage(
+	    VkShaderStageFlagBits stage,
+	    rn<Shader> shader,
+	    const char* pEntrypoint,
+	    const Specialization& specialization) noexcept
+	{
+		stages_.push_back(stage);
+		shaders_.push_back(std::move(shader));
+		entrypoints_.push_back(pEntrypoint);
+		specializations_.push_back(specialization);
+		return *this;
+	}
+
+	ShaderObjectBuilder& ShaderObjectBuilder::link() noexcept
+	{
+		link_ = true;
+		return *this;
+	}
+
+	ShaderObjectBuilder& ShaderObjectBuilder::descriptorLayout(
+	    const DescriptorLayout& layout,
+	    uint32_t set) noexcept
+	{
+		if (set >= layouts_.size())
+		{
+			layouts_.resize(set + 1);
+		}
+
+		layouts_[set] = layout;
+		return *this;
+	}
+
+	ShaderObjectBuilder& ShaderObjectBuilder::pushConstantRange(
+	    VkShaderStageFlags stages,
+	    uint32_t size,
+	    uint32_t offset) noexcept
+	{
+		pushConstants_.push_back({stages, offset, size});
+		return *this;
+	}
+
+	ShaderObjectBuilder& ShaderObjectBuilder::reflect()
+	{
+		reflect_layouts(shaders_, stages_, layouts_, pushConstants_);
+		return *this;
+	}
+
+	///////////////////////
+	//// Shader Object ////
+	///////////////////////
+
+	ShaderObject::ShaderObject(const ShaderObjectBuilder& builder)
+	    : device_(builder.device_),
+	      stages_(builder.stages_),
+	      handles_(builder.stages_.size(), VK_NULL_HANDLE)
+	{
+		const auto* pFeatures =
+		    device_->features<VkPhysicalDeviceShaderObjectFeaturesEXT>(
+		        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_FEATURES_EXT);
+
+		if (!device_->hasExtension(VK_EXT_SHADER_OBJECT_EXTENSION_NAME) ||
+		    !pFeatures || !pFeatures->shaderObject)
+		{
+			throw std::runtime_error("Shader objects need VK_EXT_shader_object "
+			                         "and its feature to be enabled");
+		}
+
+		pipelineLayout_ = create_layouts(*device_.get(),
+		                                 builder.layouts_,
+		                                 builder.pushConstants_,
+		                                 descriptorLayouts_);
+
+		std::vector<VkSpecializationInfo> specializations;
+		specializations.reserve(stages_.size());
+
+		std::vector<VkShaderCreateInfoEXT> createInfos;
+		createInfos.reserve(stages_.size());
+
+		for (size_t i = 0; i < stages_.size(); ++i)
+		{
+			std::span<uint32_t const> code = builder.shaders_[i]->code();
+
+			if (code.empty())
+			{
+				throw std::invalid_argument(
+				    "Shader objects need the SPIR-V of their shaders, which "
+				    "only loaders that keep code retain");
+			}
+
+			VkShaderCreateInfoEXT createInfo{};
+			createInfo.sType     = VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT;
+			createInfo.stage     = stages_[i];
+			createInfo.nextStage = next_stages(device_->device(), stages_[i]);
+			createInfo.codeType  = VK_SHADER_CODE_TYPE_SPIRV_EXT;
+			createInfo.codeSize  = code.size_bytes();
+			createInfo.pCode     = code.data();
+			createInfo.pName     = builder.entrypoints_[i];
+			createInfo.setLayoutCount     = descriptorLayouts_.size();
+			createInfo.pSetLayouts        = descriptorLayouts_.data();
+			createInfo.pushConstantRangeCount = builder.pushConstants_.size();
+			createInfo.pPushConstantRanges    = builder.pushConstants_.data();
+
+			if (builder.link_)
+			{
+				createInfo.flags = VK_SHADER_CREATE_LINK_STAGE_BIT_EXT;
+			}
+
+			if (!builder.specializations_[i].empty())
+			{
+				specializations.push_back(builder.specializations_[i].info());
+				createInfo.pSpecializationInfo = &specializations.back();
+			}
+
+			createInfos.push_back(createInfo);
+		}
+
+		SATURN_CALL_NO_THROW(
+		    device_->dispatch().vkCreateShadersEXT(device_,
+		                                           createInfos.size(),
+		                                           createInfos.data(),
+		                                           nullptr,
+		                                           handles_.data()))
+		{
+			// Some shaders may have been created before the failure
+			for (VkShaderEXT handle : handles_)
+			{
+				if (handle != VK_NULL_HANDLE)
+				{
+					device_->dispatch().vkDestroyShaderEXT(
+					    device_, handle, nullptr);
+				}
+			}
+
+			throw std::runtime_error("Failed to create shader objects");
+		}
+	}
+
+	ShaderObject::~ShaderObject() noexcept
+	{
+		device_->destroy([device   = device_->handle(),
+		                  pDestroy = device_->dispatch().vkDestroyShaderEXT,
+		                  handles  = handles_]() {
+			for (VkShaderEXT handle : handles)
+			{
+				pDestroy(device, handle, nullptr);
+			}
+		});
+	}
+} // namespace sat
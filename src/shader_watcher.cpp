@@ -0,0 +1,283 @@
+#include "shader_watcher.hpp"
+
+#include <exception>
+
+#ifdef __linux__
+	#include <poll.h>
+	#include <sys/inotify.h>
+	#include <unistd.h>
+#endif
+
+#include "shader.hpp"
+
+namespace sat
+{
+	/////////////////////////////
+	//// Reloadable Pipeline ////
+	/////////////////////////////
+
+	ReloadablePipeline::ReloadablePipeline(PipelineBuilder builder)
+	    : builder_(std::move(builder)), pipeline_(builder_.build())
+	{}
+
+	////////////////////////
+	//// Shader Watcher ////
+	////////////////////////
+
+	ShaderWatcher::ShaderWatcher(ShaderLoader& loader, unsigned threads)
+	    : loader_(loader), pool_(threads)
+	{
+#ifdef __linux__
+		fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+
+		if (fd_ >= 0)
+		{
+			thread_ = std::thread(&ShaderWatcher::run, this);
+		}
+	}
+
+	ShaderWatcher::~ShaderWatcher() noexcept
+	{
+		// Pending rebuilds are no longer wanted
+		stopping_ = true;
+
+		if (thread_.joinable())
+		{
+			thread_.join();
+		}
+
+#ifdef __linux__
+		if (fd_ >= 0)
+		{
+			close(fd_);
+		}
+#endif
+	}
+
+	rn<ReloadablePipeline> ShaderWatcher::watch(PipelineBuilder builder)
+	{
+		rn<ReloadablePipeline> pipeline(
+		    new ReloadablePipeline(std::move(builder)));
+
+		std::lock_guard lock(mutex_);
+
+#ifdef __linux__
+		if (fd_ >= 0)
+		{
+			for (const rn<Shader>& shader : pipeline->builder_.shaders_)
+			{
+				std::filesystem::path path = loader_.path(*shader.get());
+				if (path.empty())
+				{
+					continue;
+				}
+
+				// Watch directories, as tools often replace files by renaming
+				std::filesystem::path directory = path.parent_path();
+				if (directory.empty())
+				{
+					directory = ".";
+				}
+
+				int wd = inotify_add_watch(fd_,
+				                           directory.c_str(),
+				                           IN_CLOSE_WRITE | IN_MOVED_TO);
+				if (wd >= 0)
+				{
+					directories_[wd] = directory;
+				}
+			}
+		}
+#endif
+
+		pipelines_.push_back(pipeline);
+		return pipeline;
+	}
+
+	size_t ShaderWatcher::update()
+	{
+		std::lock_guard lock(mutex_);
+
+		size_t swapped = 0;
+
+		for (rn<ReloadablePipeline>& pipeline : pipelines_)
+		{
+			if (pipeline->pending_)
+			{
+				// The old pipeline is destroyed once the frame completes
+				pipeline->pipeline_ = std::move(*pipeline->pending_);
+				pipeline->pending_.reset();
+				++swapped;
+			}
+
+			if (pipeline->pendingError_)
+			{
+				pipeline->error_ = std::move(*pipeline->pendingError_);
+				pipeline->pendingError_.reset();
+			}
+		}
+
+		// Stop watching pipelines that nobody else holds
+		std::erase_if(pipelines_, [](const rn<ReloadablePipeline>& pipeline) {
+			return pipeline.useCount() == 1;
+		});
+
+		return swapped;
+	}
+
+	void ShaderWatcher::run() noexcept
+	{
+#ifdef __linux__
+		alignas(inotify_event) char buffer[4096];
+
+		while (!stopping_)
+		{
+			// Wake up regularly to notice that the watcher is stopping
+			pollfd pfd{fd_, POLLIN, 0};
+			if (poll(&pfd, 1, 100) <= 0)
+			{
+				continue;
+			}
+
+			ssize_t length = read(fd_, buffer, sizeof(buffer));
+			if (length <= 0)
+			{
+				continue;
+			}
+
+			std::set<std::filesystem::path> paths;
+
+			{
+				std::lock_guard lock(mutex_);
+
+				for (ssize_t offset = 0; offset < length;)
+				{
+					const auto* pEvent =
+					    reinterpret_cast<const inotify_event*>(buffer + offset);
+					offset += sizeof(inotify_event) + pEvent->len;
+
+					auto it = directories_.find(pEvent->wd);
+					if (it != directories_.end() && pEvent->len > 0)
+					{
+						paths.insert(it->second / pEvent->name);
+					}
+				}
+			}
+
+			if (!paths.empty())
+			{
+				reload(paths);
+			}
+		}
+#endif
+	}
+
+	void ShaderWatcher::reload(const std::set<std::filesystem::path>& paths)
+	{
+		std::vector<rn<ReloadablePipeline>> pipelines;
+
+		{
+			std::lock_guard lock(mutex_);
+			pipelines = pipelines_;
+		}
+
+		// Each changed file is loaded once, even when several pipelines use it
+		std::unordered_map<std::string, rn<Shader>> shaders;
+		std::unordered_map<std::string, std::string> errors;
+
+		for (rn<ReloadablePipeline>& pipeline : pipelines)
+		{
+			PipelineBuilder builder = [&]() {
+				std::lock_guard lock(mutex_);
+				return pipeline->builder_;
+			}();
+
+			bool changed = false;
+			std::string error;
+
+			for (size_t i = 0; i < builder.shaders_.size(); ++i)
+			{
+				std::filesystem::path path =
+				    loader_.path(*builder.shaders_[i].get());
+
+				if (path.empty() || !paths.contains(path))
+				{
+					continue;
+				}
+
+				std::string name = path.string();
+
+				if (!shaders.contains(name) && !errors.contains(name))
+				{
+					try
+					{
+						shaders.emplace(name, loader_.fromFile(path));
+					}
+					catch (const std::exception& e)
+					{
+						errors.emplace(name, e.what());
+					}
+				}
+
+				if (errors.contains(name))
+				{
+					error = errors.at(name);
+					break;
+				}
+
+				const rn<Shader>& shader = shaders.at(name);
+
+				// Saving a file without changing it gives the same module
+				if (shader->handle() != builder.stages_[i].module)
+				{
+					builder.shaders_[i]       = shader;
+					builder.stages_[i].module = shader->handle();
+					changed                   = true;
+				}
+			}
+
+			if (!error.empty())
+			{
+				std::lock_guard lock(mutex_);
+				pipeline->pendingError_ = std::move(error);
+				continue;
+			}
+
+			if (!changed)
+			{
+				continue;
+			}
+
+			auto rebuild = [this, pipeline, builder]() mutable {
+				if (stopping_)
+				{
+					return;
+				}
+
+				try
+				{
+					// Bindings, push constants and inputs may have changed
+					if (builder.reflected_)
+					{
+						builder.reflectAgain();
+					}
+
+					rn<Pipeline> rebuilt = builder.build();
+
+					std::lock_guard lock(mutex_);
+					pipeline->builder_      = builder;
+					pipeline->pending_      = std::move(rebuilt);
+					pipeline->pendingError_ = std::string();
+				}
+				catch (const std::exception& e)
+				{
+					std::lock_guard lock(mutex_);
+					pipeline->pendingError_ = e.what();
+				}
+			};
+
+			pool_.submit(std::move(rebuild));
+		}
+	}
+} // namespace sat
@@ -248,6 +248,7 @@ namespace sat
 	{
 		for (VkImageView view : views_)
 		{
+			device_->invalidateView(view);
 			vkDestroyImageView(device_, view, nullptr);
 		}
 
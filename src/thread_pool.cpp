@@ -0,0 +1,76 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+namespace sat
+{
+	/////////////////////
+	//// Thread Pool ////
+	/////////////////////
+
+	ThreadPool::ThreadPool(unsigned count)
+	{
+		if (count == 0)
+		{
+			count = std::max(1u, std::thread::hardware_concurrency());
+		}
+
+		threads_.reserve(count);
+
+		for (unsigned i = 0; i < count; ++i)
+		{
+			threads_.emplace_back(&ThreadPool::run, this);
+		}
+	}
+
+	ThreadPool::~ThreadPool() noexcept
+	{
+		{
+			std::lock_guard lock(mutex_);
+			stopping_ = true;
+		}
+
+		condition_.notify_all();
+
+		for (std::thread& thread : threads_)
+		{
+			thread.join();
+		}
+	}
+
+	void ThreadPool::push(std::function<void()> task)
+	{
+		{
+			std::lock_guard lock(mutex_);
+			tasks_.push(std::move(task));
+		}
+
+		condition_.notify_one();
+	}
+
+	void ThreadPool::run() noexcept
+	{
+		while (true)
+		{
+			std::function<void()> task;
+
+			{
+				std::unique_lock lock(mutex_);
+				condition_.wait(
+				    lock, [this]() { return stopping_ || !tasks_.empty(); });
+
+				// Drain remaining tasks before stopping so no future is left
+				// without a value
+				if (tasks_.empty())
+				{
+					return;
+				}
+
+				task = std::move(tasks_.front());
+				tasks_.pop();
+			}
+
+			task();
+		}
+	}
+} // namespace sat